@@ -346,6 +346,9 @@ private:
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
     void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
 
+    /// for each adduct, flag all DB entries (in the order of mass_mappings_) whose formula is compatible with the adduct (see AdductInfo::isCompatible)
+    void computeAdductCompatibility_(const std::vector<EmpiricalFormula>& db_formulas, const std::vector<AdductInfo>& adducts, std::vector<std::vector<bool> >& compatible) const;
+
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
@@ -410,6 +413,10 @@ private:
     std::vector<AdductInfo> pos_adducts_;
     std::vector<AdductInfo> neg_adducts_;
 
+    /// adduct compatibility of each DB entry, precomputed in init() (indexed as [adduct][mass_mappings_ entry])
+    std::vector<std::vector<bool> > pos_adducts_compatible_;
+    std::vector<std::vector<bool> > neg_adducts_compatible_;
+
     String database_name_;
     String database_version_;
 
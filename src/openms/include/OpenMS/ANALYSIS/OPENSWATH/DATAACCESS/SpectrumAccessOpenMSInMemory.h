@@ -107,9 +107,20 @@ public:
 
 private:
 
+    /// Builds the RT bucket index (requires spectra sorted by RT, otherwise getSpectraByRT uses a binary search)
+    void buildRTIndex_();
+
+    /// Index of the first spectrum with an RT not smaller than @p RT
+    std::size_t lowerBoundRT_(double RT) const;
+
     std::vector< OpenSwath::SpectrumPtr > spectra_;
     std::vector< OpenSwath::SpectrumMeta > spectra_meta_;
 
+    /// RT index: first spectrum with an RT of at least rt_index_min_ + b * rt_index_width_ for each bucket b
+    std::vector< std::size_t > rt_index_;
+    double rt_index_min_;
+    double rt_index_width_;
+
     std::vector< OpenSwath::ChromatogramPtr > chromatograms_;
     std::vector< std::string > chromatogram_ids_;
 
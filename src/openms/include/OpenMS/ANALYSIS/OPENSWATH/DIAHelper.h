@@ -74,6 +74,25 @@ namespace OpenMS
                                         std::vector<double>& integrated_windows_mz,
                                         bool remove_zero = false);
 
+    /**
+      @brief Integrate intensity in several windows of a spectrum
+
+      Computes the same result as calling integrateWindow (non-centroided) for
+      each window, but visits the windows in order of their start and searches
+      the spectrum onward from the previous window. This is faster if many
+      (narrow) windows of the same spectrum are needed, e.g. all isotopes of
+      all transitions of a peak group.
+
+      @param spectrum Spectrum (sorted by m/z)
+      @param windows Start and end m/z of each window (in any order)
+      @param mz Intensity-weighted m/z of each window (-1 if there is no signal)
+      @param intensity Total intensity of each window (0 if there is no signal)
+    */
+    OPENMS_DLLAPI void integrateWindows(const OpenSwath::SpectrumPtr& spectrum,
+                                        const std::vector<std::pair<double, double> >& windows,
+                                        std::vector<double>& mz,
+                                        std::vector<double>& intensity);
+
     /**
       @brief Integrate intensity in an ion mobility spectrum from start to end
 
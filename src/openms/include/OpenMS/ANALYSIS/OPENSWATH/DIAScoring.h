@@ -43,6 +43,9 @@
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ITransition.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
 
+#include <map>
+#include <mutex>
+
 namespace OpenMS
 {
   class TheoreticalSpectrumGenerator;
@@ -186,14 +189,17 @@ private:
       at a lower m/z that could explain the current peak as part of a isotope
       pattern.
 
-      @param spectrum The spectrum (MS1 or MS2)
+      @param window_mz Integrated m/z of the windows (see integrateWindows_)
+      @param window_int Integrated intensity of the windows
+      @param offset Position of the window of the peak before @p mono_mz at charge 1 (followed by those of higher charges, see addIsotopeWindows_)
       @param mono_mz The m/z value where a monoisotopic is expected
       @param mono_int The intensity of the monoisotopic peak (peak at mono_mz)
       @param nr_occurrences Will contain the count of how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
       @param nr_occurrences Will contain the maximum ratio of a peaks intensity compared to the monoisotopic peak intensity how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
 
     */
-    void largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio) const;
+    void largePeaksBeforeFirstIsotope_(const std::vector<double>& window_mz, const std::vector<double>& window_int, Size offset,
+                                       double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio) const;
 
     /**
       @brief Compare an experimental isotope pattern to a theoretical one
@@ -221,17 +227,43 @@ private:
     @brief Compare an experimental isotope pattern to a theoretical one
 
     This function will take an array of isotope intensities and compare them
-    (by order only; no m/z matching) to the theoretically expected ones given by @p isotope_dist.
-    The returned value is a Pearson correlation between the experimental and theoretical pattern.
+    (by order only; no m/z matching) to the theoretically expected ones given by @p theoretical_int
+    (scaled to a maximum of 1). The returned value is a Pearson correlation between the experimental
+    and theoretical pattern.
     */
     double scoreIsotopePattern_(const std::vector<double>& isotopes_int,
-                                const IsotopeDistribution& isotope_dist) const;
+                                const std::vector<double>& theoretical_int) const;
+
+    /// Theoretical isotope intensities (scaled to a maximum of 1) of @p formula
+    std::vector<double> computeIsotopes_(const EmpiricalFormula& formula) const;
+
+    /**
+      @brief Theoretical isotope intensities of the averagine formula for @p average_weight (see computeIsotopes_)
+
+      The patterns are cached by averagine formula. Its element counts are rounded, so the number of
+      entries is bounded by the mass range of the data (about one per 7 Da). The returned reference
+      stays valid until the parameters are changed.
+    */
+    const std::vector<double>& getAveragineIsotopes_(double average_weight) const;
 
-    /// Get the intensities of isotopes around @p precursor_mz in experimental @p spectrum
-    /// and fill @p isotopes_int.
-    void getIsotopeIntysFromExpSpec_(double precursor_mz, SpectrumPtrType spectrum,
-                                     std::vector<double>& isotopes_int,
-                                     int charge_state) const;
+    /// Append the extraction window around @p center
+    void addWindow_(double center, std::vector<std::pair<double, double> >& windows) const;
+
+    /// Number of windows appended by addIsotopeWindows_
+    Size nrIsotopeWindows_() const;
+
+    /**
+      @brief Append the extraction windows for the isotope scores of the peak at @p mono_mz
+
+      Appends the windows of isotopes 0 to dia_nr_isotopes_ (at @p charge),
+      followed by the windows of the potential peaks before @p mono_mz for
+      charges 1 to dia_nr_charges_ (see largePeaksBeforeFirstIsotope_).
+    */
+    void addIsotopeWindows_(double mono_mz, int charge, std::vector<std::pair<double, double> >& windows) const;
+
+    /// Integrate all @p windows of @p spectrum in one pass (see DIAHelpers::integrateWindows)
+    void integrateWindows_(SpectrumPtrType spectrum, const std::vector<std::pair<double, double> >& windows,
+                           std::vector<double>& mz, std::vector<double>& intensity) const;
 
     // Parameters
     double dia_extract_window_;
@@ -244,6 +276,10 @@ private:
     bool dia_centroided_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    /// theoretical isotope intensities by averagine formula (see getAveragineIsotopes_)
+    mutable std::map<String, std::vector<double> > isotope_cache_;
+    mutable std::mutex isotope_cache_mutex_;
   };
 }
 
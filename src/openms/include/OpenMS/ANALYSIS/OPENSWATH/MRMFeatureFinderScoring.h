@@ -41,6 +41,7 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SONARScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/SummedSpectrumCache.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/EmgScoring.h>
 
 // Kernel classes
@@ -59,6 +60,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <memory>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -315,6 +318,9 @@ private:
     // data
     OpenSwath::SpectrumAccessPtr ms1_map_;
 
+    /// added up spectra around the peak group apices, shared by all transition groups of one pickExperiment call (owned, never shared between instances)
+    std::unique_ptr<SummedSpectrumCache> spectrum_cache_;
+
   };
 }
 
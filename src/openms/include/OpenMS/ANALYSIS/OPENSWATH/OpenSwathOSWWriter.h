@@ -198,6 +198,76 @@ namespace OpenMS
      */
     void writeLines(const std::vector<String>& to_osw_output);
 
+    /**
+     * @brief Typed rows of the OSW feature tables
+     *
+     * Filled by prepareRows and written by writeRows using prepared
+     * statements with bound parameters, which avoids formatting every score
+     * as SQL text and having SQLite parse it again. The rows of each table
+     * are stored consecutively in one flat array since every table has a
+     * fixed number of columns.
+     *
+     */
+    struct OPENMS_DLLAPI OSWRows
+    {
+      /// A single (nullable) value of a row
+      struct Value
+      {
+        enum Type : unsigned char {NULL_VALUE, INT_VALUE, REAL_VALUE, TEXT_VALUE};
+
+        Type type = NULL_VALUE;
+        Int64 int_value = 0; ///< integer value (index into OSWRows::texts for TEXT_VALUE)
+        double real_value = 0.0;
+      };
+
+      std::vector<Value> feature; ///< rows of FEATURE
+      std::vector<Value> feature_ms1; ///< rows of FEATURE_MS1
+      std::vector<Value> feature_precursor; ///< rows of FEATURE_PRECURSOR
+      std::vector<Value> feature_ms2; ///< rows of FEATURE_MS2
+      std::vector<Value> feature_transition; ///< rows of FEATURE_TRANSITION (intensities only)
+      std::vector<Value> feature_transition_uis; ///< rows of FEATURE_TRANSITION (with UIS scores)
+      std::vector<String> texts; ///< storage of all text values
+
+      /// Whether no rows are stored
+      bool empty() const;
+
+      /// Remove all rows
+      void clear();
+
+      /// Append all rows of @p other
+      void append(const OSWRows& other);
+    };
+
+    /**
+     * @brief Prepare the rows of a transition group for output
+     *
+     * Same content as prepareLine, but the values are stored typed in @p rows
+     * (which may already contain rows of other transition groups) instead of
+     * being formatted as SQL statements.
+     *
+     * @param output The feature map containing all features (each feature will generate one entry in the output)
+     * @param id The transition group identifier (peptide/metabolite id)
+     * @param rows The row buffer to append to
+     *
+     */
+    void prepareRows(const FeatureMap& output, const String& id, OSWRows& rows) const;
+
+    /**
+     * @brief Write rows to disk
+     *
+     * Inserts all rows within a single transaction, using one prepared
+     * statement per table.
+     *
+     * @param rows Rows generated by prepareRows
+     *
+     * @note Try to call this function as little as possible (it opens a new
+     * database connection each time)
+     *
+     * @note Only call inside an OpenMP critical section
+     *
+     */
+    void writeRows(const OSWRows& rows);
+
   };
 
 }
@@ -51,6 +51,8 @@
 
 namespace OpenMS
 {
+  class SummedSpectrumCache;
+
   /** @brief A class that calls the scoring routines
    *
    * Use this class to invoke the individual OpenSWATH scoring routines.
@@ -67,6 +69,7 @@ namespace OpenMS
     std::string spectra_addition_method_;
     double im_drift_extra_pcnt_;
     OpenSwath_Scores_Usage su_;
+    SummedSpectrumCache* spectrum_cache_;
 
   public:
 
@@ -94,6 +97,19 @@ namespace OpenMS
                     const OpenSwath_Scores_Usage & su,
                     const std::string& spectrum_addition_method);
 
+    /** @brief Use a cache for the added up spectra
+     *
+     * The spectra fetched around the apex of a peak group (see
+     * fetchSpectrumSwath) are stored in @p cache and re-used for the other
+     * scores of the peak group as well as for other peak groups with their
+     * apex at the same scan. The cache is not owned, needs to outlive the
+     * scoring object and may only hold spectra computed with the same
+     * parameters (see initialize) and spectrum maps. Use nullptr (default)
+     * to disable caching.
+     *
+    */
+    void setSpectrumCache(SummedSpectrumCache* cache);
+
     /** @brief Score a single peakgroup in a chromatogram using only chromatographic properties.
      *
      * This function only uses the chromatographic properties (coelution,
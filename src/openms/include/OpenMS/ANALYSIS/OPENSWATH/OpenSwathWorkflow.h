@@ -65,6 +65,7 @@
 #include <OpenMS/FILTERING/TRANSFORMERS/LinearResamplerAlign.h>
 
 #include <cassert>
+#include <functional>
 #include <limits>
 
 // #define OPENSWATH_WORKFLOW_DEBUG
@@ -105,7 +106,7 @@ protected:
 
     /** @brief Default constructor
      *
-     *  Will not use any ms1 traces and use all threads in the outer loop.
+     *  Will not use any ms1 traces and work on as many SWATH windows at once as there are threads.
      *
      **/
     OpenSwathWorkflowBase() :
@@ -119,13 +120,8 @@ protected:
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
+     *  @param threads_outer_loop How many SWATH windows should be worked on
+     *  (and held in memory) at once (-1 will use as many as there are threads)
      *
      **/
     OpenSwathWorkflowBase(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
@@ -203,13 +199,13 @@ protected:
     /// Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
     bool prm_;
 
-    /** @brief How many threads should be used for the outer loop
+    /** @brief How many SWATH windows should be held in memory at once
      *
-     *  @note A value of -1 will use all threads in the outer loop
+     *  All threads work on batches of compounds from any of these windows
+     *  (scheduled dynamically), this only limits the memory footprint when
+     *  the data is loaded into memory.
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
+     *  @note A value of -1 will use as many windows as there are threads
      *
      **/
     int threads_outer_loop_;
@@ -231,6 +227,10 @@ protected:
    *   - Extract chromatograms across the whole RT range using simpleExtractChromatograms_()
    *   - Compute calibration functions for RT and m/z using doDataNormalization_()
    *
+   * Alternatively, the chromatograms can be extracted while the raw data is
+   * read for the first time (see getStreamingExtractionFunc()), which avoids
+   * a second pass through the SWATH maps before the main extraction.
+   *
   */
   class OPENMS_DLLAPI OpenSwathCalibrationWorkflow :
     public OpenSwathWorkflowBase
@@ -285,6 +285,56 @@ protected:
       bool sonar = false,
       bool load_into_memory = false);
 
+    /** @brief Perform RT and m/z correction using already extracted RT-normalization chromatograms.
+     *
+     * Same as the function above, but uses the provided chromatograms (e.g.
+     * from retrieveStreamingChromatograms()) instead of extracting them from
+     * @p swath_maps. The maps are still used for the m/z and ion mobility
+     * correction.
+     *
+    */
+    TransformationDescription performRTNormalization(const OpenSwath::LightTargetedExperiment & irt_transitions,
+      const std::vector< OpenMS::MSChromatogram > & irt_chromatograms,
+      std::vector< OpenSwath::SwathMap > & swath_maps,
+      TransformationDescription& im_trafo,
+      double min_rsq,
+      double min_coverage,
+      const Param & feature_finder_param,
+      const Param& irt_detection_param,
+      const Param& calibration_param,
+      const String& irt_mzml_out,
+      Size debug_level);
+
+    /** @brief Returns a function which extracts the RT-normalization chromatograms from streamed spectra
+     *
+     * The returned function can be used in
+     * MSDataTransformingConsumer::setSpectraProcessingFunc() and passed as a
+     * plugin consumer while the SWATH data is loaded. Each MS2 spectrum is
+     * assigned to its SWATH window by the precursor m/z (the same way as in
+     * FullSwathFileConsumer) and the transitions falling into that window
+     * are extracted from it directly. The result is identical to
+     * simpleExtractChromatograms_() on the loaded maps (without SONAR or ion
+     * mobility extraction). The object needs to outlive the returned function.
+     *
+     * @param irt_transitions A set of transitions used for the RT normalization peptides
+     * @param cp Parameter set for the chromatogram extraction
+     *
+     * @throw Exception::NotImplemented if @p cp requests ion mobility extraction or a filter other than "tophat"
+     *
+    */
+    std::function<void (const OpenMS::MSSpectrum&)> getStreamingExtractionFunc(const OpenSwath::LightTargetedExperiment & irt_transitions,
+                                                                                const ChromExtractParams & cp);
+
+    /** @brief Returns the chromatograms extracted by the function from getStreamingExtractionFunc()
+     *
+     * Empty chromatograms are removed (as in simpleExtractChromatograms_()),
+     * and the internal state is reset afterwards.
+     *
+     * @param chromatograms The extracted chromatograms (output)
+     *
+    */
+    void retrieveStreamingChromatograms(std::vector< OpenMS::MSChromatogram > & chromatograms);
+
   public:
 
     /** @brief Perform retention time and m/z calibration
@@ -353,6 +403,27 @@ protected:
     */
     static void addChromatograms(MSChromatogram& base_chrom, const MSChromatogram& newchrom);
 
+  private:
+
+    /// Extraction state of one SWATH window during streaming extraction
+    struct StreamingWindow_
+    {
+      double center;
+      OpenSwath::LightTargetedExperiment transitions;
+      std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+      std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+    };
+
+    /// Extract a single streamed spectrum into the chromatograms of its SWATH window
+    void extractStreamingSpectrum_(const OpenMS::MSSpectrum& spectrum);
+
+    /// Transitions to extract during streaming
+    OpenSwath::LightTargetedExperiment streaming_transitions_;
+    /// Extraction parameters used during streaming
+    ChromExtractParams streaming_cp_;
+    /// SWATH windows seen so far (in order of appearance)
+    std::vector<StreamingWindow_> streaming_windows_;
+
   };
 
   /**
@@ -391,15 +462,10 @@ protected:
      *
      *  @param use_ms1_traces Whether to use MS1 data
      *  @param use_ms1_ion_mobility Whether to use ion mobility extraction on MS1 traces
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
+     *  @param threads_outer_loop How many SWATH windows should be worked on
+     *  (and held in memory) at once (-1 will use as many as there are threads)
      *  @param prm Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
-     *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
       OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop)
@@ -0,0 +1,124 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace OpenMS
+{
+  /**
+    @brief Bounded, thread-safe cache of summed (added up) spectra
+
+    During scoring, the spectrum around the apex of a peak group is fetched
+    several times (for the different DIA, ion mobility and MS1 scores) and
+    the peak groups of a precursor and its decoys often have their apex at
+    the same scan. This class stores the most recently used spectra keyed by
+    the spectrum map, the index of the central spectrum, the number of added
+    spectra, the ion mobility window and the addition method (with its
+    resampling spacing). If more than @p capacity spectra are stored, the
+    least recently used one is evicted.
+
+    The key identifies the map by its address: clear() the cache before it
+    is used with other maps. Cached spectra are shared and must not be
+    modified. getSpectrum() may be called concurrently from several threads;
+    spectra are computed outside of the lock.
+  */
+  class OPENMS_DLLAPI SummedSpectrumCache
+  {
+  public:
+    /// spectrum map, central spectrum, number of spectra, lower and upper ion mobility, addition method, resampling spacing
+    typedef std::tuple<const OpenSwath::ISpectrumAccess*, int, int, double, double, std::string, double> Key;
+
+    /// constructor
+    explicit SummedSpectrumCache(Size capacity = 256);
+
+    /// destructor
+    virtual ~SummedSpectrumCache();
+
+    /**
+      @brief Returns the spectrum stored for @p key
+
+      On the first request, the spectrum is computed by @p compute (which is
+      called without holding the lock) and stored.
+    */
+    OpenSwath::SpectrumPtr getSpectrum(const Key& key, const std::function<OpenSwath::SpectrumPtr()>& compute);
+
+    /// Sets the maximal number of cached spectra (evicts the least recently used ones if necessary)
+    void setCapacity(Size capacity);
+
+    /// Returns the maximal number of cached spectra
+    Size getCapacity() const;
+
+    /// Returns the number of cached spectra
+    Size size() const;
+
+    /// Removes all cached spectra
+    void clear();
+
+    /// Returns the number of requests answered from the cache
+    Size getHits() const;
+
+    /// Returns the number of requests that required computing a spectrum
+    Size getMisses() const;
+
+  protected:
+    /// cache entries in order of use (most recently used first)
+    typedef std::list<std::pair<Key, OpenSwath::SpectrumPtr> > EntryList_;
+
+    /// evicts least recently used entries until at most capacity_ entries are left (lock must be held)
+    void shrink_();
+
+    Size capacity_;
+    EntryList_ entries_;
+    std::map<Key, EntryList_::iterator> index_;
+    Size hits_;
+    Size misses_;
+    mutable std::mutex mutex_;
+
+  private:
+    /// not copyable (mutex)
+    SummedSpectrumCache(const SummedSpectrumCache&) = delete;
+    SummedSpectrumCache& operator=(const SummedSpectrumCache&) = delete;
+  };
+}
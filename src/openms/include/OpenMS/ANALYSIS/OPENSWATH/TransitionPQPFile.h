@@ -39,6 +39,7 @@
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 #include <iostream>
+#include <limits>
 
 namespace OpenMS
 {
@@ -227,9 +228,13 @@ private:
      * @param filename The input file
      * @param transition_list The output list of transitions
      * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param precursor_mz_lower Only read precursors with m/z >= this value
+     * @param precursor_mz_upper Only read precursors with m/z < this value
      *
     */
-    void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
+    void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false,
+                       double precursor_mz_lower = -std::numeric_limits<double>::max(),
+                       double precursor_mz_upper = std::numeric_limits<double>::max());
 
     /** @brief Write a TargetedExperiment to a file
      *
@@ -274,6 +279,24 @@ public:
     */
     void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
 
+    /** @brief Read in the part of a PQP file within a precursor m/z range (Light transition structure)
+     *
+     * Only precursors with @p precursor_mz_lower <= m/z < @p precursor_mz_upper
+     * and their transitions, compounds and proteins are read. The range is
+     * applied inside the SQL query, so the rest of the library is never
+     * materialized. This allows loading a library one SWATH window (or one
+     * group of windows) at a time.
+     *
+     * @param filename The input file
+     * @param targeted_exp The output targeted experiment
+     * @param precursor_mz_lower Lower precursor m/z bound (inclusive)
+     * @param precursor_mz_upper Upper precursor m/z bound (exclusive)
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     *
+    */
+    void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp,
+                                        double precursor_mz_lower, double precursor_mz_upper, bool legacy_traml_id = false);
+
   };
 }
 
@@ -35,6 +35,7 @@ set(sources_list_h
   SwathWindowLoader.h
   SwathQC.h
   SpectrumAddition.h
+  SummedSpectrumCache.h
   TargetedSpectraExtractor.h
   TransitionTSVFile.h
   TransitionPQPFile.h
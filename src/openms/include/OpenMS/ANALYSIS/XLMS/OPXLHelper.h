@@ -97,6 +97,8 @@ namespace OpenMS
 
           Assumes the list of peptides and the list of spectrum precursor masses are sorted by mass in ascending order,
           and the list of mono-link masses is sorted in descending order.
+          Peptide pairs are enumerated with a two-pointer sweep over the sorted peptide masses, so only pairs with a combined mass
+          inside the precursor window are visited. The output order is deterministic, independent of the number of threads.
 
        * @param peptides The peptides with precomputed masses from the digestDatabase function
        * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
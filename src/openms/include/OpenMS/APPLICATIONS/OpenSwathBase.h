@@ -105,10 +105,13 @@ private:
     SwathFile swath_file;
     swath_file.setLogType(log_type_);
 
+    // the persistent cache is only available for single mzML files, other inputs are cached per run
+    const String run_readoptions = (readoptions == "cachePersistent") ? String("cache") : readoptions;
+
     if (split_file || file_list.size() > 1)
     {
       // TODO cannot use data reduction here any more ...
-      swath_maps = swath_file.loadSplit(file_list, tmp, exp_meta, readoptions);
+      swath_maps = swath_file.loadSplit(file_list, tmp, exp_meta, run_readoptions);
     }
     else
     {
@@ -119,7 +122,7 @@ private:
       }
       else if (in_file_type == FileTypes::MZXML)
       {
-        swath_maps = swath_file.loadMzXML(file_list[0], tmp, exp_meta, readoptions);
+        swath_maps = swath_file.loadMzXML(file_list[0], tmp, exp_meta, run_readoptions);
       }
       else if (in_file_type == FileTypes::SQMASS)
       {
@@ -149,7 +152,7 @@ protected:
    * @param file_list The input file(s)
    * @param split_file If loading a single file that contains a single SWATH window 
    * @param tmp Temporary directory
-   * @param readoptions Description on how to read the data ("normal", "cache")
+   * @param readoptions Description on how to read the data ("normal", "cache", "cachePersistent")
    * @param swath_windows_file Provided file containing the SWATH windows which will be mapped to the experimental windows
    * @param min_upper_edge_dist Distance for each assay to the upper edge of the SWATH window
    * @param force Whether to override the sanity check
@@ -306,11 +309,15 @@ protected:
    * @param tr_type Input file type
    * @param tr_file Input file name
    * @param tsv_reader_param Parameters on how to interpret spectral data
+   * @param precursor_mz_lower Only load precursors with m/z >= this value (PQP only)
+   * @param precursor_mz_upper Only load precursors with m/z < this value (PQP only)
    *
    */
   OpenSwath::LightTargetedExperiment loadTransitionList(const FileTypes::Type& tr_type,
                                                         const String& tr_file,
-                                                        const Param& tsv_reader_param)
+                                                        const Param& tsv_reader_param,
+                                                        double precursor_mz_lower = -std::numeric_limits<double>::max(),
+                                                        double precursor_mz_upper = std::numeric_limits<double>::max())
   {
     OpenSwath::LightTargetedExperiment transition_exp;
     ProgressLogger progresslogger;
@@ -326,7 +333,8 @@ protected:
     else if (tr_type == FileTypes::PQP)
     {
       progresslogger.startProgress(0, 1, "Load PQP file");
-      TransitionPQPFile().convertPQPToTargetedExperiment(tr_file.c_str(), transition_exp);
+      TransitionPQPFile().convertPQPToTargetedExperiment(tr_file.c_str(), transition_exp,
+                                                         precursor_mz_lower, precursor_mz_upper);
       progresslogger.endProgress();
     }
     else if (tr_type == FileTypes::TSV)
@@ -375,6 +383,10 @@ protected:
    *        the transformation parameters will be stored in this file)
    * @param irt_mzml_out Output Chromatogram mzML containing the iRT peptides (if not empty,
    *        iRT chromatograms will be stored in this file)
+   * @param irt_transitions_in The transitions of irt_tr_file if they were already loaded (if null, irt_tr_file is loaded)
+   * @param irt_chromatograms Chromatograms of the transitions in irt_tr_file which were already
+   *        extracted while loading the data (see OpenSwathCalibrationWorkflow::getStreamingExtractionFunc()).
+   *        If not null, they are used instead of extracting them from @p swath_maps.
    *
    */
   TransformationDescription performCalibration(String trafo_in,
@@ -390,7 +402,9 @@ protected:
         bool sonar,
         bool load_into_memory,
         const String& irt_trafo_out,
-        const String& irt_mzml_out)
+        const String& irt_mzml_out,
+        const OpenSwath::LightTargetedExperiment* irt_transitions_in = nullptr,
+        const std::vector< OpenMS::MSChromatogram >* irt_chromatograms = nullptr)
   {
     TransformationDescription trafo_rtnorm;
 
@@ -408,23 +422,38 @@ protected:
     }
     else if (!irt_tr_file.empty())
     {
-      // Loading iRT file
-      std::cout << "Will load iRT transitions and try to find iRT peptides" << std::endl;
-      TraMLFile traml;
-      FileTypes::Type tr_type = FileHandler::getType(irt_tr_file);
-      Param tsv_reader_param = TransitionTSVFile().getDefaults();
-      OpenSwath::LightTargetedExperiment irt_transitions = loadTransitionList(tr_type, irt_tr_file, tsv_reader_param);
+      // Loading iRT file (unless this was already done for the streaming extraction)
+      OpenSwath::LightTargetedExperiment loaded_irt_transitions;
+      if (irt_transitions_in == nullptr)
+      {
+        std::cout << "Will load iRT transitions and try to find iRT peptides" << std::endl;
+        FileTypes::Type tr_type = FileHandler::getType(irt_tr_file);
+        Param tsv_reader_param = TransitionTSVFile().getDefaults();
+        loaded_irt_transitions = loadTransitionList(tr_type, irt_tr_file, tsv_reader_param);
+      }
+      const OpenSwath::LightTargetedExperiment& irt_transitions = (irt_transitions_in != nullptr) ? *irt_transitions_in : loaded_irt_transitions;
 
       // perform extraction
       OpenSwathCalibrationWorkflow wf;
       wf.setLogType(log_type_);
       TransformationDescription im_trafo;
-      trafo_rtnorm = wf.performRTNormalization(irt_transitions, swath_maps, im_trafo,
-                                               min_rsq, min_coverage,
-                                               feature_finder_param,
-                                               cp_irt, irt_detection_param,
-                                               calibration_param, irt_mzml_out, debug_level, sonar,
-                                               load_into_memory);
+      if (irt_chromatograms != nullptr)
+      {
+        trafo_rtnorm = wf.performRTNormalization(irt_transitions, *irt_chromatograms, swath_maps, im_trafo,
+                                                 min_rsq, min_coverage,
+                                                 feature_finder_param,
+                                                 irt_detection_param,
+                                                 calibration_param, irt_mzml_out, debug_level);
+      }
+      else
+      {
+        trafo_rtnorm = wf.performRTNormalization(irt_transitions, swath_maps, im_trafo,
+                                                 min_rsq, min_coverage,
+                                                 feature_finder_param,
+                                                 cp_irt, irt_detection_param,
+                                                 calibration_param, irt_mzml_out, debug_level, sonar,
+                                                 load_into_memory);
+      }
 
       if (!irt_trafo_out.empty())
       {
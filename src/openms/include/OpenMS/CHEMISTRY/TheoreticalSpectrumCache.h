@@ -0,0 +1,137 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace OpenMS
+{
+  class AASequence;
+
+  /**
+      @brief Bounded, thread-safe cache of theoretical spectra
+
+      Workflows often generate the spectrum of the same peptide many times (e.g. when
+      re-annotating search results after the actual search). This class wraps a
+      TheoreticalSpectrumGenerator and keeps the most recently used spectra, keyed by
+      peptide sequence (including modifications), charge range and precursor charge.
+      If more than @p capacity spectra are stored, the least recently used one is evicted.
+
+      The generator (and thus its parameters) is fixed for the lifetime of the cache;
+      setGenerator() replaces it and clears all cached spectra. To generate m/z and
+      intensities only (without ion name and charge data arrays), set the generator
+      parameter "add_metainfo" to "false".
+
+      Cached spectra are shared and must not be modified. getSpectrum() may be called
+      concurrently from several threads; spectra are generated outside of the lock.
+  */
+  class OPENMS_DLLAPI TheoreticalSpectrumCache
+  {
+  public:
+    /// shared, read-only spectrum as returned by the cache
+    typedef std::shared_ptr<const PeakSpectrum> SpectrumPtr;
+
+    /// constructor (the generator is copied)
+    explicit TheoreticalSpectrumCache(const TheoreticalSpectrumGenerator& generator = TheoreticalSpectrumGenerator(), Size capacity = 10000);
+
+    /// destructor
+    virtual ~TheoreticalSpectrumCache();
+
+    /**
+      @brief Returns the theoretical spectrum of @p peptide
+
+      The spectrum is generated (see TheoreticalSpectrumGenerator::getSpectrum) on the first request and
+      taken from the cache afterwards.
+
+      @throw Exception::InvalidParameter as TheoreticalSpectrumGenerator::getSpectrum
+    */
+    SpectrumPtr getSpectrum(const AASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge = 0);
+
+    /**
+      @brief Replaces the generator and clears the cache (spectra generated with other parameters must not be reused)
+
+      @note Spectra are generated outside of the lock, so this must not be called while other threads are in getSpectrum().
+    */
+    void setGenerator(const TheoreticalSpectrumGenerator& generator);
+
+    /// Returns a copy of the generator (a reference could be invalidated by a concurrent setGenerator())
+    TheoreticalSpectrumGenerator getGenerator() const;
+
+    /// Sets the maximal number of cached spectra (evicts the least recently used ones if necessary)
+    void setCapacity(Size capacity);
+
+    /// Returns the maximal number of cached spectra
+    Size getCapacity() const;
+
+    /// Returns the number of cached spectra
+    Size size() const;
+
+    /// Removes all cached spectra
+    void clear();
+
+    /// Returns the number of requests answered from the cache
+    Size getHits() const;
+
+    /// Returns the number of requests that required generating a spectrum
+    Size getMisses() const;
+
+  protected:
+    /// cache entries in order of use (most recently used first)
+    typedef std::list<std::pair<String, SpectrumPtr> > EntryList_;
+
+    /// evicts least recently used entries until at most capacity_ entries are left (lock must be held)
+    void shrink_();
+
+    TheoreticalSpectrumGenerator generator_;
+    Size capacity_;
+    EntryList_ entries_;
+    std::unordered_map<String, EntryList_::iterator> index_;
+    Size hits_;
+    Size misses_;
+    mutable std::mutex mutex_;
+
+  private:
+    /// not copyable (mutex)
+    TheoreticalSpectrumCache(const TheoreticalSpectrumCache&) = delete;
+    TheoreticalSpectrumCache& operator=(const TheoreticalSpectrumCache&) = delete;
+  };
+}
@@ -307,6 +307,8 @@ e conditions are fulfilled. Mainly the
      * is assumed that candidates[0] is the monoisotopic trace.
      *
      * The resulting possible groupings are appended to output_hypotheses.
+     * Is called concurrently for different candidates, thus output_hypotheses
+     * must not be shared between threads.
     */
     void findLocalFeatures_(const std::vector<const MassTrace*>& candidates, double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const;
 
@@ -337,6 +339,9 @@ e conditions are fulfilled. Mainly the
 
     bool remove_single_traces_;
     std::vector<const Element*> elements_;
+
+    /// Theoretic isotopic mass windows of elements_, indexed by isotopic position (filled by run())
+    std::vector<Range> isotope_windows_;
   };
 
 }
@@ -40,6 +40,8 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <boost/dynamic_bitset_fwd.hpp>
+
 namespace OpenMS
 {
 
@@ -110,6 +112,30 @@ namespace OpenMS
           Size peak_idx;
         };
 
+        /// A mass trace collected starting from an apex
+        struct TraceCandidate
+        {
+          /// (scan index, peak index) of all collected peaks, the apex first
+          std::vector<std::pair<Size, Size> > gathered_idx;
+          /// the mass trace (only set if the candidate is valid)
+          MassTrace trace;
+          /// whether the trace fulfills the length and quality criteria
+          bool is_valid = false;
+        };
+
+        /**
+          @brief Extends a mass trace from @p apex in both directions of RT
+
+          Only reads @p peak_visited and may thus be called concurrently for
+          different apices.
+        */
+        void extendTrace_(const Apex& apex,
+                          const PeakMap& work_exp,
+                          const std::vector<Size>& spec_offsets,
+                          const boost::dynamic_bitset<>& peak_visited,
+                          const int fwhm_meta_idx,
+                          TraceCandidate& candidate);
+
         /// The internal run method
         void run_(const std::vector<Apex>& chrom_apices,
                   const Size peak_count,
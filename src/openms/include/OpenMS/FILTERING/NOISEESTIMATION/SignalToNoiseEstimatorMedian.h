@@ -41,6 +41,8 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <vector>
+#include <set>
+#include <iterator>
 #include <algorithm> //for std::max_element
 
 namespace OpenMS
@@ -65,6 +67,11 @@ namespace OpenMS
     case you should increase <i>max_intensity</i> (and optionally the
     <i>bin_count</i>).
 
+    Alternatively, the median can be computed exactly (param: <i>median_method</i> = exact).
+    The intensities of the current window are then kept sorted in two halves while the window
+    slides over the scan, so each step costs O(log(window size)) and the histogram parameters
+    (<i>bin_count</i>, <i>max_intensity</i>, <i>auto_mode</i>) are not used.
+
     Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
 
     @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>OPENMS_LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
@@ -133,6 +140,9 @@ public:
 
       defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
 
+      defaults_.setValue("median_method", "histogram", "Method to determine the median of a window: 'histogram' approximates it using 'bin_count' bins up to 'max_intensity'; 'exact' keeps the intensities of the sliding window sorted and ignores the histogram parameters.");
+      defaults_.setValidStrings("median_method", ListUtils::create<String>("histogram,exact"));
+
       defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows or median in rightmost histogram bin");
       defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
 
@@ -201,6 +211,12 @@ protected:
       stn_estimates_.clear();
       stn_estimates_.resize(c.size());
 
+      if (exact_median_)
+      {
+        computeExactSTN_(c);
+        return;
+      }
+
       // maximal range of histogram needs to be calculated first
       if (auto_mode_ == AUTOMAXBYSTDEV)
       {
@@ -393,6 +409,114 @@ protected:
 
     } // end of shiftWindow_
 
+    /**
+      @brief Calculates the signal-to-noise values with the exact median of each sliding window
+
+      The window is the same as for the histogram based estimation. Its intensities are kept in two
+      sorted halves, @p lower holds the smaller ceil(n/2) values, so the median (the same order statistic
+      the histogram estimate looks for) is the largest element of @p lower.
+    */
+    void computeExactSTN_(const Container& c)
+    {
+      std::multiset<double> lower;
+      std::multiset<double> upper;
+      // restore |lower| - |upper| in {0, 1} after a single insertion or removal
+      auto rebalance = [&lower, &upper]()
+      {
+        if (lower.size() > upper.size() + 1)
+        {
+          std::multiset<double>::iterator largest = std::prev(lower.end());
+          upper.insert(*largest);
+          lower.erase(largest);
+        }
+        else if (upper.size() > lower.size())
+        {
+          lower.insert(*upper.begin());
+          upper.erase(upper.begin());
+        }
+      };
+
+      PeakIterator window_pos_center = c.begin();
+      PeakIterator window_pos_borderleft = c.begin();
+      PeakIterator window_pos_borderright = c.begin();
+
+      const double window_half_size = win_len_ / 2;
+      int window_count = 0;
+
+      SignalToNoiseEstimator<Container>::startProgress(0, c.size(), "noise estimation of data");
+
+      while (window_pos_center != c.end())
+      {
+        // remove all elements that leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() < (*window_pos_center).getMZ() - window_half_size)
+        {
+          const double intensity = (*window_pos_borderleft).getIntensity();
+          // the value is part of the window, so a value not above the largest of the lower half is found there
+          if (intensity <= *lower.rbegin())
+          {
+            lower.erase(lower.find(intensity));
+          }
+          else
+          {
+            upper.erase(upper.find(intensity));
+          }
+          rebalance();
+          ++window_pos_borderleft;
+        }
+
+        // add all elements that enter the window on the RIGHT side
+        while ((window_pos_borderright != c.end())
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          const double intensity = (*window_pos_borderright).getIntensity();
+          if (lower.empty() || intensity <= *lower.rbegin())
+          {
+            lower.insert(intensity);
+          }
+          else
+          {
+            upper.insert(intensity);
+          }
+          rebalance();
+          ++window_pos_borderright;
+        }
+
+        double noise;
+        if ((int)(lower.size() + upper.size()) < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          // just avoid division by 0 (like the histogram estimate)
+          noise = std::max(1.0, *lower.rbegin());
+        }
+
+        stn_estimates_[window_count] = (*window_pos_center).getIntensity() / noise;
+
+        ++window_pos_center;
+        ++window_count;
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+      }
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      if (window_count > 0)
+      {
+        sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
+      }
+
+      // warn if percentage of sparse windows is above 20%
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
     /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
     void updateMembers_() override
     {
@@ -405,6 +529,7 @@ protected:
       min_required_elements_   = param_.getValue("min_required_elements");
       noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
       write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      exact_median_            = param_.getValue("median_method") == "exact";
       stn_estimates_.clear();
     }
 
@@ -429,6 +554,9 @@ protected:
     // whether to write out log messages in the case of failure
     bool write_log_messages_;
 
+    // whether to compute the exact median of each window instead of the histogram estimate
+    bool exact_median_;
+
     // counter for sparse windows
     double sparse_window_percent_;
     // counter for histogram overflow
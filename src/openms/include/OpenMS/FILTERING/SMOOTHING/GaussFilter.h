@@ -188,24 +188,11 @@ public:
     /**
       @brief Smoothes an MSExperiment containing profile data.
 
-      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
+
+      @exception Exception::IllegalArgument is thrown, if the ppm tolerance is used and the map contains chromatograms.
     */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & map);
 
 protected:
 
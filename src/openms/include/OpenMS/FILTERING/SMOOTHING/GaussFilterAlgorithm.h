@@ -39,6 +39,7 @@
 #include <OpenMS/INTERFACES/DataStructures.h>
 #include <OpenMS/INTERFACES/ISpectrumAccess.h>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 namespace OpenMS
@@ -60,6 +61,12 @@ namespace OpenMS
           Use a gaussian filter kernel which has approximately the same width as your mass peaks,
           whereas the gaussian peak width corresponds approximately to 8*sigma.
 
+    For equidistant data (and a fixed kernel width) the kernel weights are the same for every
+    data point. They are computed once and the convolution runs over a contiguous buffer,
+    which the compiler can vectorize. If the kernel width depends on m/z (ppm tolerance), the
+    kernel is tabulated piecewise: consecutive data points whose width rounds to the same
+    value on a grid with 0.01% relative steps share one table.
+
     @note The data must be sorted according to ascending m/z!
 
     @ingroup SignalProcessing
@@ -135,21 +142,43 @@ public:
         ConstIterT mz_in_end,
         ConstIterT int_in_start,
         IterT mz_out,
-        IterT int_out)
+        IterT int_out) const
     {
       bool found_signal = false;
 
+      // equidistant data with a fixed kernel: convolute with precomputed weights
+      double data_spacing = 0.0;
+      if (!use_ppm_tolerance_ && isEquidistant_(mz_in_start, mz_in_end, data_spacing) && !hasPointsOnKernelBorder_(data_spacing))
+      {
+        const Size n = std::distance(mz_in_start, mz_in_end);
+        std::vector<double> intensities(int_in_start, int_in_start + n);
+        std::vector<double> smoothed;
+        found_signal = filterEquidistant_(intensities, data_spacing, smoothed);
+        for (Size i = 0; i < n; ++i, ++mz_in_start)
+        {
+          *mz_out = *mz_in_start;
+          *int_out = smoothed[i];
+          ++mz_out;
+          ++int_out;
+        }
+        return found_signal;
+      }
+
+      // kernel table of the current ppm piece
+      std::vector<double> ppm_coeffs;
+      int ppm_piece = std::numeric_limits<int>::min();
+
       ConstIterT mz_it = mz_in_start;
       ConstIterT int_it = int_in_start;
       for (; mz_it != mz_in_end; mz_it++, int_it++)
       {
-        // if ppm tolerance is used, calculate a reasonable width value for this m/z
+        // if ppm tolerance is used, use the kernel for the width at this m/z
         if (use_ppm_tolerance_)
         {
-          initialize((*mz_it) * ppm_tolerance_ * 10e-6, spacing_, ppm_tolerance_, use_ppm_tolerance_ );
+          updatePpmCoefficients_(*mz_it, ppm_piece, ppm_coeffs);
         }
 
-        double new_int = integrate_(mz_it, int_it, mz_in_start, mz_in_end);
+        double new_int = integrate_(mz_it, int_it, mz_in_start, mz_in_end, use_ppm_tolerance_ ? ppm_coeffs : coeffs_);
         
         // store new intensity and m/z into output iterator
         *mz_out = *mz_it;
@@ -177,197 +206,128 @@ protected:
     bool use_ppm_tolerance_;
     double ppm_tolerance_;
 
-    /// Computes the convolution of the raw data at position x and the gaussian kernel
-    template <typename InputPeakIterator>
-    double integrate_(InputPeakIterator x /* mz */, InputPeakIterator y /* int */, InputPeakIterator first, InputPeakIterator last)
-    {
-      double v = 0.;
-      // norm the gaussian kernel area to one
-      double norm = 0.;
-      Size middle = coeffs_.size();
+    /// Tabulates the kernel with standard deviation @p sigma at the positions 0, spacing_, 2 * spacing_, ... into @p coeffs
+    void computeCoefficients_(double sigma, Size number_of_points_right, std::vector<double>& coeffs) const;
 
-      double start_pos = (( (*x) - (middle * spacing_)) > (*first)) ? ((*x) - (middle * spacing_)) : (*first);
-      double end_pos = (( (*x) + (middle * spacing_)) < (*(last - 1))) ? ((*x) + (middle * spacing_)) : (*(last - 1));
+    /**
+      @brief Updates @p coeffs to the kernel of the ppm-dependent width at @p mz
 
-      InputPeakIterator help_x = x;
-      InputPeakIterator help_y = y;
-#ifdef DEBUG_FILTERING
+      The width is rounded to a grid with 0.01% relative steps, while the number of tabulated
+      points (and thereby the integration window) follows the exact width. @p piece is the grid
+      index of the table in @p coeffs, which is only recomputed if the index or size changes.
+    */
+    void updatePpmCoefficients_(double mz, int& piece, std::vector<double>& coeffs) const;
 
-      std::cout << "integrate from middle to start_pos " << *help_x << " until " << start_pos << std::endl;
-#endif
+    /**
+      @brief Convolutes equidistant data with fixed kernel weights
 
-      //integrate from middle to start_pos
-      while ((help_x != first) && (*(help_x - 1) > start_pos))
-      {
-        // search for the corresponding datapoint of help in the gaussian (take the left most adjacent point)
-        double distance_in_gaussian = fabs(*x - *help_x);
-        Size left_position = (Size)floor(distance_in_gaussian / spacing_);
+      @param intensities The intensities of the data points
+      @param data_spacing The distance between two neighbouring data points
+      @param smoothed The smoothed intensities (output)
+      @return Whether any smoothed intensity is non-zero
+    */
+    bool filterEquidistant_(const std::vector<double>& intensities, double data_spacing, std::vector<double>& smoothed) const;
 
-        // search for the true left adjacent data point (because of rounding errors)
-        for (int j = 0; ((j < 3) &&  (distance(first, help_x - j) >= 0)); ++j)
-        {
-          if (((left_position - j) * spacing_ <= distance_in_gaussian) && ((left_position - j + 1) * spacing_ >= distance_in_gaussian))
-          {
-            left_position -= j;
-            break;
-          }
-
-          if (((left_position + j) * spacing_ < distance_in_gaussian) && ((left_position + j + 1) * spacing_ < distance_in_gaussian))
-          {
-            left_position += j;
-            break;
-          }
-        }
+    /**
+      @brief Checks whether data points with the given spacing fall onto the border of the kernel
 
-        // interpolate between the left and right data points in the gaussian to get the true value at position distance_in_gaussian
-        Size right_position = left_position + 1;
-        double d = fabs((left_position * spacing_) - distance_in_gaussian) / spacing_;
-        // check if the right data point in the gaussian exists
-        double coeffs_right = (right_position < middle) ? (1 - d) * coeffs_[left_position] + d * coeffs_[right_position]
-                                  : coeffs_[left_position];
-#ifdef DEBUG_FILTERING
+      Whether such points are part of the integration window depends on rounding errors in
+      their positions, which only the general path reproduces.
+    */
+    bool hasPointsOnKernelBorder_(double data_spacing) const;
 
-        std::cout << "distance_in_gaussian " << distance_in_gaussian << std::endl;
-        std::cout << " right_position " << right_position << std::endl;
-        std::cout << " left_position " << left_position << std::endl;
-        std::cout << "coeffs_ at left_position "  <<  coeffs_[left_position] << std::endl;
-        std::cout << "coeffs_ at right_position "  <<  coeffs_[right_position] << std::endl;
-        std::cout << "interpolated value left " << coeffs_right << std::endl;
-#endif
+    /// Checks whether the positions are equidistant (within 1e-6 of their mean spacing) and returns that spacing
+    template <typename ConstIterT>
+    static bool isEquidistant_(ConstIterT first, ConstIterT last, double& data_spacing)
+    {
+      const Size n = std::distance(first, last);
+      if (n < 3) return false;
 
+      data_spacing = (*(last - 1) - *first) / (n - 1);
+      if (!(data_spacing > 0)) return false;
 
-        // search for the corresponding datapoint for (help-1) in the gaussian (take the left most adjacent point)
-        distance_in_gaussian = fabs((*x) - (*(help_x - 1)));
-        left_position = (Size)floor(distance_in_gaussian / spacing_);
+      const double tolerance = data_spacing * 1e-6;
+      for (ConstIterT it = first + 1; it != last; ++it)
+      {
+        if (fabs((*it - *(it - 1)) - data_spacing) > tolerance) return false;
+      }
+      return true;
+    }
 
-        // search for the true left adjacent data point (because of rounding errors)
-        for (UInt j = 0; ((j < 3) && (distance(first, help_x - j) >= 0)); ++j)
-        {
-          if (((left_position - j) * spacing_ <= distance_in_gaussian) && ((left_position - j + 1) * spacing_ >= distance_in_gaussian))
-          {
-            left_position -= j;
-            break;
-          }
-
-          if (((left_position + j) * spacing_ < distance_in_gaussian) && ((left_position + j + 1) * spacing_ < distance_in_gaussian))
-          {
-            left_position += j;
-            break;
-          }
-        }
+    /// Returns the kernel value at @p distance from the center, interpolated linearly between the tabulated @p coeffs
+    double coefficient_(const std::vector<double>& coeffs, double distance) const
+    {
+      const Size middle = coeffs.size();
+      Size left_position = (Size)floor(distance / spacing_);
+      // the division may round up to the right adjacent point
+      if (left_position > 0 && left_position * spacing_ > distance)
+      {
+        --left_position;
+      }
+      if (left_position >= middle)
+      {
+        return coeffs.back();
+      }
 
-        // start the interpolation for the true value in the gaussian
-        right_position = left_position + 1;
-        d = fabs((left_position * spacing_) - distance_in_gaussian) / spacing_;
-        double coeffs_left = (right_position < middle) ? (1 - d) * coeffs_[left_position] + d * coeffs_[right_position]
-                                 : coeffs_[left_position];
-#ifdef DEBUG_FILTERING
+      // interpolate between the left and right data points in the gaussian to get the true value at position distance
+      const Size right_position = left_position + 1;
+      const double d = fabs((left_position * spacing_) - distance) / spacing_;
+      // check if the right data point in the gaussian exists
+      return (right_position < middle) ? (1 - d) * coeffs[left_position] + d * coeffs[right_position]
+                                       : coeffs[left_position];
+    }
 
-        std::cout << " help_x-1 " << *(help_x - 1) << " distance_in_gaussian " << distance_in_gaussian << std::endl;
-        std::cout << " right_position " << right_position << std::endl;
-        std::cout << " left_position " << left_position << std::endl;
-        std::cout << "coeffs_ at left_position " <<  coeffs_[left_position] << std::endl;
-        std::cout << "coeffs_ at right_position " <<   coeffs_[right_position] << std::endl;
-        std::cout << "interpolated value right " << coeffs_left << std::endl;
+    /**
+      @brief Computes the convolution of the raw data at position x and the gaussian kernel
 
-        std::cout << " intensity " << fabs(*(help_x - 1) - (*help_x)) / 2. << " * " << *(help_y - 1) << " * " << coeffs_left << " + " << *help_y << "* " << coeffs_right
-                  << std::endl;
-#endif
+      The kernel value of each data point is looked up once and reused for both adjacent trapezoids.
+    */
+    template <typename InputPeakIterator>
+    double integrate_(InputPeakIterator x /* mz */, InputPeakIterator y /* int */, InputPeakIterator first, InputPeakIterator last,
+                      const std::vector<double>& coeffs) const
+    {
+      double v = 0.;
+      // norm the gaussian kernel area to one
+      double norm = 0.;
+      Size middle = coeffs.size();
 
+      double start_pos = (( (*x) - (middle * spacing_)) > (*first)) ? ((*x) - (middle * spacing_)) : (*first);
+      double end_pos = (( (*x) + (middle * spacing_)) < (*(last - 1))) ? ((*x) + (middle * spacing_)) : (*(last - 1));
 
+      const double coeff_center = coefficient_(coeffs, 0.0);
+
+      //integrate from middle to start_pos
+      InputPeakIterator help_x = x;
+      InputPeakIterator help_y = y;
+      double coeffs_right = coeff_center;
+      while ((help_x != first) && (*(help_x - 1) > start_pos))
+      {
+        double coeffs_left = coefficient_(coeffs, fabs((*x) - (*(help_x - 1))));
+#ifdef DEBUG_FILTERING
+        std::cout << " help_x-1 " << *(help_x - 1) << " interpolated value left " << coeffs_left << " right " << coeffs_right << std::endl;
+#endif
         norm += fabs((*(help_x - 1)) - (*help_x)) / 2. * (coeffs_left + coeffs_right);
 
         v += fabs((*(help_x - 1)) - (*help_x)) / 2. * (*(help_y - 1) * coeffs_left + (*help_y) * coeffs_right);
+        coeffs_right = coeffs_left;
         --help_x;
         --help_y;
       }
 
-
       //integrate from middle to end_pos
       help_x = x;
       help_y = y;
-#ifdef DEBUG_FILTERING
-
-      std::cout << "integrate from middle to endpos " << *help_x << " until " << end_pos << std::endl;
-#endif
-
+      double coeffs_left = coeff_center;
       while ((help_x != (last - 1)) && (*(help_x + 1) < end_pos))
       {
-        // search for the corresponding datapoint for help in the gaussian (take the left most adjacent point)
-        double distance_in_gaussian = fabs((*x) - (*help_x));
-        int left_position = (UInt)floor(distance_in_gaussian / spacing_);
-
-        // search for the true left adjacent data point (because of rounding errors)
-        for (int j = 0; ((j < 3) && (distance(help_x + j, last - 1) >= 0)); ++j)
-        {
-          if (((left_position - j) * spacing_ <= distance_in_gaussian) && ((left_position - j + 1) * spacing_ >= distance_in_gaussian))
-          {
-            left_position -= j;
-            break;
-          }
-
-          if (((left_position + j) * spacing_ < distance_in_gaussian) && ((left_position + j + 1) * spacing_ < distance_in_gaussian))
-          {
-            left_position += j;
-            break;
-          }
-        }
-        // start the interpolation for the true value in the gaussian
-        Size right_position = left_position + 1;
-        double d = fabs((left_position * spacing_) - distance_in_gaussian) / spacing_;
-        double coeffs_left = (right_position < middle) ? (1 - d) * coeffs_[left_position] + d * coeffs_[right_position]
-                                 : coeffs_[left_position];
-
+        double coeffs_right = coefficient_(coeffs, fabs((*x) - (*(help_x + 1))));
 #ifdef DEBUG_FILTERING
-
-        std::cout << " help " << *help_x << " distance_in_gaussian " << distance_in_gaussian << std::endl;
-        std::cout << " left_position " << left_position << std::endl;
-        std::cout << "coeffs_ at right_position " <<  coeffs_[left_position] << std::endl;
-        std::cout << "coeffs_ at left_position " <<  coeffs_[right_position] << std::endl;
-        std::cout << "interpolated value left " << coeffs_left << std::endl;
-#endif
-
-        // search for the corresponding datapoint for (help+1) in the gaussian (take the left most adjacent point)
-        distance_in_gaussian = fabs((*x) - (*(help_x + 1)));
-        left_position = (UInt)floor(distance_in_gaussian / spacing_);
-
-        // search for the true left adjacent data point (because of rounding errors)
-        for (int j = 0; ((j < 3) && (distance(help_x + j, last - 1) >= 0)); ++j)
-        {
-          if (((left_position - j) * spacing_ <= distance_in_gaussian) && ((left_position - j + 1) * spacing_ >= distance_in_gaussian))
-          {
-            left_position -= j;
-            break;
-          }
-
-          if (((left_position + j) * spacing_ < distance_in_gaussian) && ((left_position + j + 1) * spacing_ < distance_in_gaussian))
-          {
-            left_position += j;
-            break;
-          }
-        }
-
-        // start the interpolation for the true value in the gaussian
-        right_position = left_position + 1;
-        d = fabs((left_position * spacing_) - distance_in_gaussian) / spacing_;
-        double coeffs_right = (right_position < middle) ? (1 - d) * coeffs_[left_position] + d * coeffs_[right_position]
-                                  : coeffs_[left_position];
-#ifdef DEBUG_FILTERING
-
-        std::cout << " (help + 1) " << *(help_x + 1) << " distance_in_gaussian " << distance_in_gaussian << std::endl;
-        std::cout << " left_position " << left_position << std::endl;
-        std::cout << "coeffs_ at right_position " <<   coeffs_[left_position] << std::endl;
-        std::cout << "coeffs_ at left_position " <<  coeffs_[right_position] << std::endl;
-        std::cout << "interpolated value right " << coeffs_right << std::endl;
-
-        std::cout << " intensity " <<  fabs(*help_x - *(help_x + 1)) / 2.
-                  << " * " << *help_y << " * " << coeffs_left << " + " << *(help_y + 1)
-                  << "* " << coeffs_right
-                  << std::endl;
+        std::cout << " (help + 1) " << *(help_x + 1) << " interpolated value left " << coeffs_left << " right " << coeffs_right << std::endl;
 #endif
         norm += fabs((*help_x) - (*(help_x + 1)) ) / 2. * (coeffs_left + coeffs_right);
 
         v += fabs((*help_x) - (*(help_x + 1)) ) / 2. * ((*help_y) * coeffs_left + (*(help_y + 1)) * coeffs_right);
+        coeffs_left = coeffs_right;
         ++help_x;
         ++help_y;
       }
@@ -184,49 +184,23 @@ public:
 
     /**
       @brief Removed the noise from an MSSpectrum containing profile data.
+
+      The intensities are copied to a contiguous buffer and convolved in blocks, so the
+      inner loop over the data points can be vectorized by the compiler.
     */
-    void filter(MSSpectrum & spectrum)
-    {
-      // copy the data AND META DATA to the output container
-      MSSpectrum output = spectrum;
-      // filter
-      filter(spectrum.begin(), spectrum.end(), output.begin());
-      // swap back
-      std::swap(spectrum, output);
-    }
+    void filter(MSSpectrum & spectrum);
 
     /**
       @brief Removed the noise from an MSChromatogram
     */
-    void filter(MSChromatogram & chromatogram)
-    {
-      // copy the data AND META DATA to the output container
-      MSChromatogram output = chromatogram;
-      // filter
-      filter(chromatogram.begin(), chromatogram.end(), output.begin());
-      // swap back
-      std::swap(chromatogram, output);
-    }
+    void filter(MSChromatogram & chromatogram);
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
     */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & map);
 
 protected:
     /// Coefficients
@@ -238,6 +212,13 @@ protected:
     /// The order of the smoothing polynomial.
     UInt order_;
 
+    /// Smoothes the intensities of @p container in place (no-op if it is shorter than the frame)
+    template <typename ContainerT>
+    void filterContainer_(ContainerT & container) const;
+
+    /// Convolutes @p intensities with the filter coefficients (requires at least frame_size_ points)
+    void filterIntensities_(const std::vector<double> & intensities, std::vector<double> & smoothed) const;
+
     // Docu in base class
     void updateMembers_() override;
   };
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Transforming consumer of MS data that processes the data in parallel
+
+      Works like MSDataTransformingConsumer, but the spectra and chromatograms
+      are collected into batches of at most @p batch_size elements. Each batch
+      is transformed in parallel (using OpenMP) and then passed on to the
+      downstream consumer in exactly the order in which the data was consumed.
+      Thus the output does not depend on the number of threads and at most one
+      batch is held in memory at any time.
+
+      Since the processing functions are called concurrently from several
+      threads, they must not modify shared state (e.g. use one copy of a
+      non-const filter object per thread).
+
+      If a processing function throws, all elements consumed before the failing
+      one are still passed on and the exception is rethrown in the calling
+      thread. If several elements of a batch fail, the exception of the first
+      one is rethrown.
+
+      @note Call flush() once all data has been consumed. The destructor
+      flushes remaining data as well but cannot report errors.
+
+      Usage:
+
+      @code
+      PlainMSDataWritingConsumer writer(outfile);
+      MSDataParallelTransformingConsumer parallel_consumer(&writer);
+      parallel_consumer.setSpectraProcessingFunc([&filter](MSSpectrum& s) { filter.filter(s); });
+      MzMLFile().transform(infile, &parallel_consumer);
+      parallel_consumer.flush();
+      @endcode
+    */
+    class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+      public MSDataTransformingConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer The consumer which receives the transformed data (ownership is not transferred)
+        @param batch_size Maximal number of elements held in memory (0 uses 64 elements per thread)
+      */
+      MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0);
+
+      /// Destructor (flushes remaining data)
+      ~MSDataParallelTransformingConsumer() override;
+
+      /// Passed on to the downstream consumer
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// Calls the experimental settings function (if any) and passes the settings on to the downstream consumer
+      void setExperimentalSettings(const OpenMS::ExperimentalSettings& es) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Transforms all buffered data and passes it on to the downstream consumer
+
+        @exception Any exception thrown by the processing functions
+      */
+      void flush();
+
+      /// Returns the maximal number of elements held in memory
+      Size getBatchSize() const;
+
+    protected:
+
+      /// Transforms the buffered spectra in parallel and passes them on
+      void flushSpectra_();
+
+      /// Transforms the buffered chromatograms in parallel and passes them on
+      void flushChromatograms_();
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      Size batch_size_;
+      std::vector<SpectrumType> spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+    };
+
+} //end namespace OpenMS
+
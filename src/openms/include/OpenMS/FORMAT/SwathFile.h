@@ -63,6 +63,18 @@ namespace OpenMS
    * mzXML is available but needs to be selected with a specific compile flag
    * (this is not for everyday use).
    *
+   * Using the readoptions "cachePersistent", loadMzML builds the cached maps
+   * (see CachedSwathFileConsumer) only once per raw file and tmp directory.
+   * A small manifest (<tmp><basename>_<path hash>.swathcache, keyed on the
+   * absolute path of the raw file) records the version, the source file
+   * (path, size and modification time) and the cached maps. It is published
+   * atomically after all maps are written, so any number of subsequent
+   * processes can open the same cache read-only (through
+   * SimpleOpenMSSpectraFactory) without parsing the raw file again; the
+   * operating system page cache is shared between these processes. A stale
+   * cache is removed and rebuilt. If a plugin consumer is given, the raw file
+   * is still parsed once to feed it, even if the cache is re-used.
+   *
    */
   class OPENMS_DLLAPI SwathFile :
     public ProgressLogger
@@ -87,7 +99,7 @@ public:
       @param [IN] file Input filename
       @param [IN] tmp Temporary directory (for cached data)
       @param [OUT] exp_meta Experimental metadata from mzML file
-      @param [IN] readoptions How are spectra accessed after reading - tradeoff between memory usage and time (disk caching)
+      @param [IN] readoptions How are spectra accessed after reading - tradeoff between memory usage and time (disk caching): "normal", "cache", "cachePersistent" or "split"
       @param [IN] plugin_consumer An intermediate custom consumer
       @return Swath maps for MS2 and MS1 (unless readoptions == split, which returns no data)
     */
@@ -106,8 +118,30 @@ public:
     /// Loads a Swath run from a single sqMass file
     std::vector<OpenSwath::SwathMap> loadSqMass(String file, boost::shared_ptr<ExperimentalSettings>& /* exp_meta */);
 
+    /// Version of the persistent cache manifest (increase when its layout changes)
+    static constexpr int PERSISTENT_CACHE_VERSION = 1;
+
 protected:
 
+    /// Path of the persistent cache manifest of @p file in @p tmp
+    static String getPersistentCacheManifest_(const String& file, const String& tmp);
+
+    /// Manifest lines identifying the current version of @p file (path, size and modification time)
+    static StringList getPersistentCacheKey_(const String& file);
+
+    /// Store the experimental settings and publish the manifest for maps cached under @p tmp_fname
+    void storePersistentCache_(const String& file, const String& tmp, const String& tmp_fname,
+                               const ExperimentalSettings& settings, int nr_ms1_spectra,
+                               const std::vector<OpenSwath::SwathMap>& swath_maps);
+
+    /// Open an existing persistent cache of @p file; returns false if it is missing or stale
+    bool loadPersistentCache_(const String& file, const String& tmp,
+                              boost::shared_ptr<ExperimentalSettings>& exp_meta, int& nr_ms1_spectra,
+                              std::vector<OpenSwath::SwathMap>& swath_maps);
+
+    /// Remove the manifest @p manifest (read as @p lines) and all cache files it lists
+    static void removePersistentCache_(const String& manifest, const String& tmp, const std::vector<String>& lines);
+
     /// Cache a file to disk
     OpenSwath::SpectrumAccessPtr doCacheFile_(const String& in, const String& tmp, const String& tmp_fname,
                                               boost::shared_ptr<PeakMap > experiment_metadata);
@@ -82,9 +82,13 @@ public:
   PeakMap& getMSData() { return ms_data_; }
   const PeakMap& getMSData() const { return ms_data_; }
 
+  /// chromatograms (XICs) of all chunks, in chunk order (only filled if setKeepChromatograms() was enabled before run())
   PeakMap& getChromatograms() { return chrom_data_; }
   const PeakMap& getChromatograms() const { return chrom_data_; }
 
+  /// keep the extracted chromatograms for output (see getChromatograms())?
+  void setKeepChromatograms(bool keep) { keep_chromatograms_ = keep; }
+
   ProgressLogger& getProgressLogger() { return prog_log_; }
   const ProgressLogger& getProgressLogger() const { return prog_log_; }
 
@@ -206,6 +210,7 @@ protected:
 
   PeakMap ms_data_; ///< input LC-MS data
   PeakMap chrom_data_; ///< accumulated chromatograms (XICs)
+  bool keep_chromatograms_ = false; ///< fill chrom_data_?
   TargetedExperiment library_; ///< accumulated assays for peptides
 
   bool quantify_decoys_;
@@ -254,6 +259,13 @@ protected:
   /// @param clear_IDs set to false to keep IDs in internal charge maps (only needed for debugging purposes)
   void createAssayLibrary_(const PeptideMap::iterator& begin, const PeptideMap::iterator& end, PeptideRefRTMap& ref_rt_map, bool clear_IDs = true);
 
+  /// extracts chromatograms for the assays in @p library from @p ms_map and detects features in them
+  /// (uses its own copy of the feature finder, thus may be called concurrently);
+  /// the chromatograms are moved to @p chunk_chromatograms unless it is null; returns the number of chromatograms
+  Size detectFeaturesInChunk_(const TargetedExperiment& library, const OpenSwath::SpectrumAccessPtr& ms_map,
+                              const MSSpectrum& template_spectrum, FeatureMap& chunk_features,
+                              std::vector<MSChromatogram>* chunk_chromatograms = nullptr) const;
+
   /// CAUTION: This method stores a pointer to the given @p peptide reference in internals
   /// Make sure it stays valid until destruction of the class.
   /// @todo find better solution
@@ -42,6 +42,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <exception>
 #include <numeric>
 
 namespace OpenMS
@@ -567,21 +568,26 @@ namespace OpenMS
 
     // Depending on ion_mode_internal_, either positive or negative adducts are used
     std::vector<AdductInfo>::const_iterator it_s, it_e;
+    const std::vector<std::vector<bool> >* adducts_compatible;
     if (ion_mode == "positive")
     {
       it_s = pos_adducts_.begin();
       it_e = pos_adducts_.end();
+      adducts_compatible = &pos_adducts_compatible_;
     }
     else if (ion_mode == "negative")
     {
       it_s = neg_adducts_.begin();
       it_e = neg_adducts_.end();
+      adducts_compatible = &neg_adducts_compatible_;
     }
     else
     {
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
     }
 
+    const bool mass_error_ppm = (mass_error_unit_ == "ppm");
+
     std::pair<Size, Size> hit_idx;
     for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
     {
@@ -607,7 +613,7 @@ namespace OpenMS
       // (the other approach is to precompute m/z values for all combinations of adducts, charges and DB entries -- too much)
       double diff_mz;
       // check if mass error window is given in ppm or Da
-      if (mass_error_unit_ == "ppm")
+      if (mass_error_ppm)
       {
         // convert ppm to absolute m/z tolerance for the current candidate
         diff_mz = (observed_mz / 1e6) * mass_error_value_;
@@ -626,11 +632,14 @@ namespace OpenMS
 
       //std::cerr << ion_mode_internal_ << " adduct: " << adduct_name << ", " << adduct_mass << " Da, " << query_mass << " qm(against DB), " << charge << " q\n";
 
+      // compatibility of DB entries with this adduct (precomputed in init())
+      const std::vector<bool>& compatible = (*adducts_compatible)[it - it_s];
+
       // store information from query hits in AccurateMassSearchResult objects
       for (Size i = hit_idx.first; i < hit_idx.second; ++i)
       {
         // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        if (!compatible[i])
         {
           // only written if TOPP tool has --debug
           OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
@@ -772,9 +781,49 @@ namespace OpenMS
     parseAdductsFile_(pos_adducts_fname_, pos_adducts_);
     parseAdductsFile_(neg_adducts_fname_, neg_adducts_);
 
+    // parse each DB formula only once and check it against all adducts up front,
+    // instead of once per query hit and adduct
+    std::vector<EmpiricalFormula> db_formulas(mass_mappings_.size());
+    std::vector<Size> invalid_formulas;
+    for (Size i = 0; i < mass_mappings_.size(); ++i)
+    {
+      try
+      {
+        db_formulas[i] = EmpiricalFormula(mass_mappings_[i].formula);
+      }
+      catch (Exception::BaseException& e)
+      { // a single malformed DB entry must not abort the whole search; it just can never be reported as a hit
+        OPENMS_LOG_WARN << "Warning: DB entry with formula '" << mass_mappings_[i].formula << "' cannot be parsed (" << e.what() << "). Omitting it.\n";
+        invalid_formulas.push_back(i);
+      }
+    }
+    computeAdductCompatibility_(db_formulas, pos_adducts_, pos_adducts_compatible_);
+    computeAdductCompatibility_(db_formulas, neg_adducts_, neg_adducts_compatible_);
+    for (Size i : invalid_formulas)
+    {
+      for (std::vector<bool>& row : pos_adducts_compatible_) row[i] = false;
+      for (std::vector<bool>& row : neg_adducts_compatible_) row[i] = false;
+    }
+
     is_initialized_ = true;
   }
 
+  void AccurateMassSearchEngine::computeAdductCompatibility_(const std::vector<EmpiricalFormula>& db_formulas, const std::vector<AdductInfo>& adducts, std::vector<std::vector<bool> >& compatible) const
+  {
+    compatible.assign(adducts.size(), std::vector<bool>(db_formulas.size(), false));
+
+    // one row per adduct: rows are written by exactly one thread (std::vector<bool> packs bits, so rows must not be shared)
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize a = 0; a < static_cast<SignedSize>(adducts.size()); ++a)
+    {
+      std::vector<bool>& row = compatible[a];
+      for (Size i = 0; i < db_formulas.size(); ++i)
+      {
+        row[i] = adducts[a].isCompatible(db_formulas[i]);
+      }
+    }
+  }
+
   void AccurateMassSearchEngine::run(FeatureMap& fmap, MzTab& mztab_out) const
   {
     if (!is_initialized_)
@@ -788,39 +837,77 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
+    if (!fmap.empty() && mass_mappings_.empty())
+    { // checked here, since searchMass_() must not throw inside the parallel region below
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
+    }
+
+    // features are queried independently: search (and score isotope patterns) in parallel,
+    // then annotate the features and collect results in feature order
+    std::vector<std::vector<AccurateMassSearchResult> > feature_results(fmap.size());
+    std::vector<std::exception_ptr> errors(fmap.size());
+    std::vector<char> missing_masstraces(fmap.size(), false); // warned about after the parallel region
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < static_cast<SignedSize>(fmap.size()); ++i)
+    {
+      try
+      {
+        std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
+
+        // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
+        queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+
+        if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
+
+        bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
+
+        if (iso_similarity_ && !is_dummy)
+        {
+          if (!fmap[i].metaValueExists("num_of_masstraces"))
+          {
+            missing_masstraces[i] = true;
+          }
+          else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
+          { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
+            // it is impossible to decide here which one is best
+            for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
+            {
+              String emp_formula(query_results[hit_idx].getFormulaString());
+              double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
+              query_results[hit_idx].setIsotopesSimScore(iso_sim);
+            }
+          }
+        }
+      }
+      catch (...)
+      {
+        // cannot throw inside the parallel region (e.g. unparsable adduct or sum formula)
+        errors[i] = std::current_exception();
+      }
+    }
+
     // map for storing overall results
     QueryResultsTable overall_results;
     Size dummy_count(0);
     for (Size i = 0; i < fmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
+      if (errors[i])
+      {
+        std::rethrow_exception(errors[i]);
+      }
+      if (missing_masstraces[i])
+      {
+        OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity." << std::endl;
+      }
 
-      // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+      std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
 
       if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
 
       bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
       if (is_dummy) ++dummy_count;
 
-      if (iso_similarity_ && !is_dummy)
-      {
-        if (!fmap[i].metaValueExists("num_of_masstraces"))
-        {
-          OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
-        }
-        else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
-        { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
-          // it is impossible to decide here which one is best
-          for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
-          {
-            String emp_formula(query_results[hit_idx].getFormulaString());
-            double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
-            query_results[hit_idx].setIsotopesSimScore(iso_sim);
-          }
-        }
-      }
-
       // debug output
       //        for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
       //        {
@@ -828,8 +915,8 @@ namespace OpenMS
       //        }
 
       // String feat_label(fmap[i].getMetaValue(3));
-      overall_results.push_back(query_results);
       annotate_(query_results, fmap[i]);
+      overall_results.push_back(std::move(query_results));
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     fmap.getProteinIdentifications().resize(fmap.getProteinIdentifications().size() + 1);
@@ -902,16 +989,37 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
+    if (!cmap.empty() && mass_mappings_.empty())
+    { // checked here, since searchMass_() must not throw inside the parallel region below
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
+    }
+
     // map for storing overall results
-    QueryResultsTable overall_results;
+    QueryResultsTable overall_results(cmap.size());
+    std::vector<std::exception_ptr> errors(cmap.size());
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < static_cast<SignedSize>(cmap.size()); ++i)
+    {
+      try
+      {
+        // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
+        queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, overall_results[i]);
+      }
+      catch (...)
+      {
+        // cannot throw inside the parallel region
+        errors[i] = std::current_exception();
+      }
+    }
 
     for (Size i = 0; i < cmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
-      // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
-      annotate_(query_results, cmap[i]);
-      overall_results.push_back(query_results);
+      if (errors[i])
+      {
+        std::rethrow_exception(errors[i]);
+      }
+      annotate_(overall_results[i], cmap[i]);
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     cmap.getProteinIdentifications().resize(cmap.getProteinIdentifications().size() + 1);
@@ -282,39 +282,43 @@ namespace OpenMS
         map<double, double> score_to_fdr;
         calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
 
-        // annotate fdr
-        for (auto it = ids.begin(); it != ids.end(); ++it)
+        // annotate fdr (in place; identifications are independent of each other)
+#pragma omp parallel for schedule(dynamic, 1000)
+        for (SignedSize id_idx = 0; id_idx < static_cast<SignedSize>(ids.size()); ++id_idx)
         {
+          PeptideIdentification& id = ids[id_idx];
           // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
+          if (treat_runs_separately && id.getIdentifier() != *iit)
           {
             continue;
           }
 
-          String score_type = it->getScoreType() + "_score";
-          vector<PeptideHit> hits;
-          for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
+          String score_type = id.getScoreType() + "_score";
+          vector<PeptideHit>& hits = id.getHits();
+          Size kept = 0;
+          for (Size h = 0; h < hits.size(); ++h)
           {
-            PeptideHit hit = *pit;
+            PeptideHit& hit = hits[h];
 
-            if (split_charge_variants && pit->getCharge() != *zit)
-            {
-              hits.push_back(*pit);
-              continue;
-            }
-            if (hit.metaValueExists("target_decoy"))
+            if (!(split_charge_variants && hit.getCharge() != *zit))
             {
-              String meta_value = (String)hit.getMetaValue("target_decoy");
-              if (meta_value == "decoy" && !add_decoy_peptides)
+              if (!add_decoy_peptides && hit.metaValueExists("target_decoy") &&
+                  (String)hit.getMetaValue("target_decoy") == "decoy")
               {
-                continue;
+                continue; // drop this decoy hit
               }
+              // scores without target/decoy annotation are not in the map and get FDR 0
+              map<double, double>::const_iterator fdr_it = score_to_fdr.find(hit.getScore());
+              hit.setMetaValue(score_type, hit.getScore());
+              hit.setScore(fdr_it != score_to_fdr.end() ? fdr_it->second : 0.0);
+            }
+            if (kept != h)
+            {
+              hits[kept] = std::move(hit);
             }
-            hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
-            hits.push_back(hit);
+            ++kept;
           }
-          it->getHits().swap(hits);
+          hits.resize(kept);
         }
       }
       if (!split_charge_variants)
@@ -679,26 +683,33 @@ namespace OpenMS
   void FalseDiscoveryRate::calculateFDRs_(map<double, double>& score_to_fdr, vector<double>& target_scores, vector<double>& decoy_scores, bool q_value, bool higher_score_better) const
   {
     Size number_of_target_scores = target_scores.size();
-    // sort the scores
-    if (higher_score_better && !q_value)
+    // sort the scores (targets and decoys are independent, so sort them concurrently)
+    // targets: decreasing if higher_score_better XOR q_value; decoys: decreasing if higher_score_better
+    bool targets_decreasing = (higher_score_better != q_value);
+#pragma omp parallel sections
     {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
-    }
-    else if (!higher_score_better && !q_value)
-    {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.begin(), decoy_scores.end());
-    }
-    else if (higher_score_better)
-    {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
-    }
-    else
-    {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.begin(), decoy_scores.end());
+#pragma omp section
+      {
+        if (targets_decreasing)
+        {
+          sort(target_scores.rbegin(), target_scores.rend());
+        }
+        else
+        {
+          sort(target_scores.begin(), target_scores.end());
+        }
+      }
+#pragma omp section
+      {
+        if (higher_score_better)
+        {
+          sort(decoy_scores.rbegin(), decoy_scores.rend());
+        }
+        else
+        {
+          sort(decoy_scores.begin(), decoy_scores.end());
+        }
+      }
     }
 
     Size j = 0;
@@ -791,12 +802,18 @@ namespace OpenMS
       const double& ds = decoy_scores[i];
 
       // advance target index until score is better than decoy score
-      size_t k{0};
-      while (k != target_scores.size() &&
-             ((target_scores[k] <= ds && higher_score_better) ||
-              (target_scores[k] >= ds && !higher_score_better)))
+      auto not_better = [&ds, higher_score_better](double ts)
       {
-        ++k;
+        return (ts <= ds && higher_score_better) || (ts >= ds && !higher_score_better);
+      };
+      size_t k{0};
+      if (q_value)
+      { // targets are sorted worst to best: the targets that are not better than the decoy form a prefix
+        k = partition_point(target_scores.begin(), target_scores.end(), not_better) - target_scores.begin();
+      }
+      else if (!target_scores.empty() && not_better(target_scores[0]))
+      { // targets are sorted best to worst: if the best one is not better than the decoy, none is
+        k = target_scores.size();
       }
 
       // corner cases
@@ -472,8 +472,18 @@ namespace OpenMS
     bool fragment_error_unit_ppm(true);
     if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+    const bool positive_mode = (ion_mode_ == "positive");
+    const bool negative_mode = (ion_mode_ == "negative");
+
+    // spectra are matched independently of each other: collect the results per spectrum
+    // and concatenate them afterwards to keep the output order
+    vector<vector<SpectralMatch> > spectrum_results(msexp.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize spec_idx = 0; spec_idx < static_cast<SignedSize>(msexp.size()); ++spec_idx)
     {
+      vector<SpectralMatch>& spectrum_matches = spectrum_results[spec_idx];
+
       // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
 
       // iterate over all precursor masses
@@ -517,7 +527,7 @@ namespace OpenMS
           // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
 
           // check for charge state of precursor ions: do they match?
-          if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+          if ( (positive_mode && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (negative_mode && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
           {
             continue;
           }
@@ -565,7 +575,7 @@ namespace OpenMS
           for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
           {
             // cout << "score: " << partial_results[result_idx].getMatchingScore() << " " << partial_results[result_idx].getMatchingSpectrumIndex() << endl;
-            matching_results.push_back(partial_results[result_idx]);
+            spectrum_matches.push_back(partial_results[result_idx]);
           }
         }
 
@@ -573,13 +583,18 @@ namespace OpenMS
         {
           if (partial_results.size() > 0)
           {
-            matching_results.push_back(partial_results[0]);
+            spectrum_matches.push_back(partial_results[0]);
           }
         }
 
       } // end precursor loop
     } // end spectra loop
 
+    for (const vector<SpectralMatch>& spectrum_matches : spectrum_results)
+    {
+      matching_results.insert(matching_results.end(), spectrum_matches.begin(), spectrum_matches.end());
+    }
+
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
   }
@@ -39,6 +39,7 @@
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumCache.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 #include <OpenMS/CHEMISTRY/DecoyGenerator.h>
@@ -263,6 +264,9 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     bool annotation_precursor_error_ppm = std::find(annotate_psm_.begin(), annotate_psm_.end(), Constants::UserParam::PRECURSOR_ERROR_PPM_USERPARAM) != annotate_psm_.end();
     bool annotation_fragment_error_ppm = std::find(annotate_psm_.begin(), annotate_psm_.end(), Constants::UserParam::FRAGMENT_ERROR_MEDIAN_PPM_USERPARAM) != annotate_psm_.end();
 
+    // theoretical spectra are shared between threads and hits of the same peptide
+    TheoreticalSpectrumCache theo_spectra_cache;
+
 #pragma omp parallel for
     for (SignedSize scan_index = 0; scan_index < (SignedSize)annotated_hits.size(); ++scan_index)
     {
@@ -302,10 +306,9 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
 
           if (annotation_fragment_error_ppm)
           {
-            TheoreticalSpectrumGenerator tsg;
             vector<pair<Size, Size> > alignment;
-            MSSpectrum theoretical_spec;
-            tsg.getSpectrum(theoretical_spec, fixed_and_variable_modified_peptide, 1, std::min((int)charge - 1, 2));
+            TheoreticalSpectrumCache::SpectrumPtr theoretical_spec_ptr = theo_spectra_cache.getSpectrum(fixed_and_variable_modified_peptide, 1, std::min((int)charge - 1, 2));
+            const MSSpectrum& theoretical_spec = *theoretical_spec_ptr;
             SpectrumAlignment sa;
             sa.getSpectrumAlignment(alignment, theoretical_spec, spec);
 
@@ -37,6 +37,8 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
 #include <iostream>
 
 namespace OpenMS
@@ -296,14 +298,82 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // Each coordinate is only active on the spectra within its RT range. If
+    // the spectra are sorted by RT (the usual case), this range is a
+    // contiguous block [first_scan, last_scan) which we determine by binary
+    // search. We then sweep once through the spectra and only visit the
+    // currently active coordinates instead of testing all of them against
+    // every spectrum.
+    std::vector<double> spectrum_rts(input_size);
+    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    {
+      spectrum_rts[scan_idx] = input->getSpectrumMetaById(scan_idx).RT;
+    }
+    const bool rt_sorted = std::is_sorted(spectrum_rts.begin(), spectrum_rts.end());
+
+    const Size nr_coordinates = extraction_coordinates.size();
+    std::vector<Size> first_scan(nr_coordinates, 0);
+    std::vector<Size> last_scan(nr_coordinates, input_size);
+    for (Size k = 0; k < nr_coordinates; ++k)
+    {
+      const ExtractionCoordinates& coord = extraction_coordinates[k];
+      const bool has_rt_range = coord.rt_end - coord.rt_start > 0;
+      if (has_rt_range && rt_sorted)
+      {
+        first_scan[k] = std::lower_bound(spectrum_rts.begin(), spectrum_rts.end(), coord.rt_start) - spectrum_rts.begin();
+        last_scan[k] = std::upper_bound(spectrum_rts.begin(), spectrum_rts.end(), coord.rt_end) - spectrum_rts.begin();
+      }
+      if (!has_rt_range || rt_sorted)
+      {
+        // we know the number of data points in advance (upper bound, since
+        // empty spectra are skipped)
+        Size nr_points = last_scan[k] > first_scan[k] ? last_scan[k] - first_scan[k] : 0;
+        output[k]->getTimeArray()->data.reserve(output[k]->getTimeArray()->data.size() + nr_points);
+        output[k]->getIntensityArray()->data.reserve(output[k]->getIntensityArray()->data.size() + nr_points);
+      }
+    }
+
+    // coordinates ordered by the scan at which they become active (ties keep m/z order)
+    std::vector<Size> activation_order(nr_coordinates);
+    for (Size k = 0; k < nr_coordinates; ++k) activation_order[k] = k;
+    std::stable_sort(activation_order.begin(), activation_order.end(),
+      [&first_scan](Size a, Size b) { return first_scan[a] < first_scan[b]; });
+
+    // active coordinates, always kept in m/z order (i.e. ascending index)
+    std::vector<Size> active, next_active;
+    active.reserve(nr_coordinates);
+    next_active.reserve(nr_coordinates);
+    Size activation_idx = 0;
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
     {
       setProgress(scan_idx);
 
+      // update the set of active coordinates: drop the ones whose RT range
+      // has ended and merge in the ones starting at this spectrum
+      next_active.clear();
+      for (Size k : active)
+      {
+        if (last_scan[k] > scan_idx) next_active.push_back(k);
+      }
+      const Size nr_still_active = next_active.size();
+      while (activation_idx < nr_coordinates && first_scan[activation_order[activation_idx]] <= scan_idx)
+      {
+        Size k = activation_order[activation_idx++];
+        if (last_scan[k] > scan_idx) next_active.push_back(k);
+      }
+      std::inplace_merge(next_active.begin(), next_active.begin() + nr_still_active, next_active.end());
+      active.swap(next_active);
+
+      if (active.empty())
+      {
+        continue;
+      }
+
       OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+      const double current_rt = spectrum_rts[scan_idx];
 
       OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
       OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
@@ -334,15 +404,14 @@ namespace OpenMS
         }
       }
 
-      // go through all transitions / chromatograms which are sorted by
+      // go through all active transitions / chromatograms which are sorted by
       // ProductMZ. We can use this to step through the spectrum and at the
       // same time step through the transitions. We increase the peak counter
       // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      for (Size k : active)
       {
         double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
+        if (!rt_sorted && extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
              (current_rt < extraction_coordinates[k].rt_start ||
               current_rt > extraction_coordinates[k].rt_end) )
         {
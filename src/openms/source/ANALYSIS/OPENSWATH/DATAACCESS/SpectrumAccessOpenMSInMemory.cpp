@@ -38,7 +38,9 @@
 namespace OpenMS
 {
 
-  SpectrumAccessOpenMSInMemory::SpectrumAccessOpenMSInMemory(OpenSwath::ISpectrumAccess & origin)
+  SpectrumAccessOpenMSInMemory::SpectrumAccessOpenMSInMemory(OpenSwath::ISpectrumAccess & origin) :
+    rt_index_min_(0.0),
+    rt_index_width_(0.0)
   {
     // special case: we can grab the data directly (and fast)
     if (dynamic_cast<SpectrumAccessSqMass*> (&origin))
@@ -60,6 +62,8 @@ namespace OpenMS
       }
     }
 
+    buildRTIndex_();
+
     OPENMS_POSTCONDITION(spectra_.size() == spectra_meta_.size(), "Spectra and meta data needs to match")
     OPENMS_POSTCONDITION(chromatogram_ids_.size() == chromatograms_.size(), "Chromatograms and meta data needs to match")
   }
@@ -70,7 +74,10 @@ namespace OpenMS
     spectra_(rhs.spectra_),
     spectra_meta_(rhs.spectra_meta_),
     chromatograms_(rhs.chromatograms_),
-    chromatogram_ids_(rhs.chromatogram_ids_)
+    chromatogram_ids_(rhs.chromatogram_ids_),
+    rt_index_(rhs.rt_index_),
+    rt_index_min_(rhs.rt_index_min_),
+    rt_index_width_(rhs.rt_index_width_)
   {
     // this only copies the pointers and not the actual data ... 
   }
@@ -102,21 +109,78 @@ namespace OpenMS
     // beginning of the RT domain. Then we add this spectrum and try to add
     // further spectra as long as they are below RT + deltaRT.
     std::vector<std::size_t> result;
-    OpenSwath::SpectrumMeta s;
-    s.RT = RT - deltaRT;
-    auto spectrum = std::lower_bound(spectra_meta_.begin(), spectra_meta_.end(), s, OpenSwath::SpectrumMeta::RTLess());
-    if (spectrum == spectra_meta_.end()) return result;
-
-    result.push_back(std::distance(spectra_meta_.begin(), spectrum));
-    ++spectrum;
-    while (spectrum->RT < RT + deltaRT && spectrum != spectra_meta_.end())
+    std::size_t idx = lowerBoundRT_(RT - deltaRT);
+    if (idx == spectra_meta_.size()) return result;
+
+    result.push_back(idx);
+    ++idx;
+    while (idx < spectra_meta_.size() && spectra_meta_[idx].RT < RT + deltaRT)
     {
-      result.push_back(std::distance(spectra_meta_.begin(), spectrum));
-      ++spectrum;
+      result.push_back(idx);
+      ++idx;
     }
     return result;
   }
 
+  void SpectrumAccessOpenMSInMemory::buildRTIndex_()
+  {
+    rt_index_.clear();
+    const std::size_t n = spectra_meta_.size();
+    if (n < 2 || !std::is_sorted(spectra_meta_.begin(), spectra_meta_.end(), OpenSwath::SpectrumMeta::RTLess()))
+    {
+      return;
+    }
+    rt_index_min_ = spectra_meta_.front().RT;
+    double rt_range = spectra_meta_.back().RT - rt_index_min_;
+    if (!(rt_range > 0.0))
+    {
+      return;
+    }
+
+    // one bucket per spectrum on average, so a lookup only has to skip very few spectra
+    rt_index_width_ = rt_range / n;
+    rt_index_.resize(n + 1);
+    std::size_t idx = 0;
+    for (std::size_t b = 0; b < rt_index_.size(); ++b)
+    {
+      double bucket_rt = rt_index_min_ + b * rt_index_width_;
+      while (idx < n && spectra_meta_[idx].RT < bucket_rt)
+      {
+        ++idx;
+      }
+      rt_index_[b] = idx;
+    }
+  }
+
+  std::size_t SpectrumAccessOpenMSInMemory::lowerBoundRT_(double RT) const
+  {
+    if (rt_index_.empty())
+    {
+      OpenSwath::SpectrumMeta s;
+      s.RT = RT;
+      auto spectrum = std::lower_bound(spectra_meta_.begin(), spectra_meta_.end(), s, OpenSwath::SpectrumMeta::RTLess());
+      return std::distance(spectra_meta_.begin(), spectrum);
+    }
+    if (!(RT > rt_index_min_))
+    {
+      return 0;
+    }
+
+    // all spectra before rt_index_[b] have an RT below the bucket start (and thus below RT)
+    double bucket = (RT - rt_index_min_) / rt_index_width_;
+    std::size_t b = bucket < rt_index_.size() - 1 ? static_cast<std::size_t>(bucket) : rt_index_.size() - 1;
+    if (b > 0 && rt_index_min_ + b * rt_index_width_ > RT)
+    {
+      --b; // rounding
+    }
+    std::size_t idx = rt_index_[b];
+    while (idx < spectra_meta_.size() && spectra_meta_[idx].RT < RT)
+    {
+      ++idx;
+    }
+    return idx;
+  }
+
   size_t SpectrumAccessOpenMSInMemory::getNrSpectra() const
   {
     OPENMS_PRECONDITION(spectra_.size() == spectra_meta_.size(), "Spectra and meta data needs to match")
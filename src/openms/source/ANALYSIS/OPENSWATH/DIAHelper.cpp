@@ -42,6 +42,7 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <algorithm>
 #include <utility>
 #include <boost/bind.hpp>
 
@@ -93,6 +94,56 @@ namespace OpenMS
       }
     }
 
+    void integrateWindows(const OpenSwath::SpectrumPtr& spectrum,
+                          const std::vector<std::pair<double, double> >& windows,
+                          std::vector<double>& mz,
+                          std::vector<double>& intensity)
+    {
+      OPENMS_PRECONDITION(spectrum->getMZArray()->data.size() == spectrum->getIntensityArray()->data.size(), "MZ and Intensity array need to have the same length.");
+      OPENMS_PRECONDITION(std::adjacent_find(spectrum->getMZArray()->data.begin(),
+              spectrum->getMZArray()->data.end(), std::greater<double>()) == spectrum->getMZArray()->data.end(),
+              "Precondition violated: m/z vector needs to be sorted!" )
+
+      mz.assign(windows.size(), -1);
+      intensity.assign(windows.size(), 0);
+
+      std::vector<Size> order(windows.size());
+      for (Size i = 0; i < order.size(); ++i) order[i] = i;
+      std::sort(order.begin(), order.end(), [&windows](Size a, Size b) { return windows[a].first < windows[b].first; });
+
+      const std::vector<double>& mz_arr = spectrum->getMZArray()->data;
+      const std::vector<double>& int_arr = spectrum->getIntensityArray()->data;
+      const Size n = mz_arr.size();
+      Size pos = 0; // first peak that is not below the start of the current window
+      for (Size w : order)
+      {
+        const double mz_start = windows[w].first;
+        const double mz_end = windows[w].second;
+
+        // windows are visited by increasing start: gallop forward from the
+        // previous position, then binary search in the last step
+        Size step = 1;
+        while (pos + step < n && mz_arr[pos + step] < mz_start)
+        {
+          step *= 2;
+        }
+        pos = std::lower_bound(mz_arr.begin() + pos + step / 2, mz_arr.begin() + std::min(pos + step, n), mz_start) - mz_arr.begin();
+
+        // same summation order as integrateWindow
+        double sum_int = 0, sum_mz = 0;
+        for (Size k = pos; k < n && mz_arr[k] < mz_end; ++k)
+        {
+          sum_int += int_arr[k];
+          sum_mz += int_arr[k] * mz_arr[k];
+        }
+        if (sum_int > 0.)
+        {
+          mz[w] = sum_mz / sum_int;
+          intensity[w] = sum_int;
+        }
+      }
+    }
+
     void integrateDriftSpectrum(OpenSwath::SpectrumPtr spectrum, 
                                               double mz_start,
                                               double mz_end,
@@ -51,6 +51,7 @@
 #include <numeric>
 #include <algorithm>
 #include <functional>
+#include <mutex>
 
 #include <boost/bind.hpp>
 
@@ -118,6 +119,10 @@ namespace OpenMS
     dia_nr_isotopes_ = (int)param_.getValue("dia_nr_isotopes");
     dia_nr_charges_ = (int)param_.getValue("dia_nr_charges");
     peak_before_mono_max_ppm_diff_ = (double)param_.getValue("peak_before_mono_max_ppm_diff");
+
+    // theoretical patterns depend on the number of isotopes
+    std::lock_guard<std::mutex> lock(isotope_cache_mutex_);
+    isotope_cache_.clear();
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -144,18 +149,25 @@ namespace OpenMS
     ppm_score = 0;
     ppm_score_weighted = 0;
     diff_ppm.clear();
+
+    std::vector<std::pair<double, double> > windows;
+    windows.reserve(transitions.size());
+    for (const TransitionType& transition : transitions)
+    {
+      addWindow_(transition.getProductMZ(), windows);
+    }
+    std::vector<double> window_mz, window_int;
+    integrateWindows_(spectrum, windows, window_mz, window_int);
+
     for (std::size_t k = 0; k < transitions.size(); k++)
     {
       const TransitionType& transition = transitions[k];
       // Calculate the difference of the theoretical mass and the actually measured mass
-      double left(transition.getProductMZ()), right(transition.getProductMZ());
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      bool signalFound = DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      double mz = window_mz[k];
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
-      if (!signalFound)
+      if (!(window_int[k] > 0.))
       {
         continue;
       }
@@ -207,8 +219,11 @@ namespace OpenMS
     // although precursor_mz can be received from the empirical formula (if non-empty), the actual precursor could be
     // slightly different. And also for compounds, usually the neutral sum_formula without adducts is given.
     // Therefore calculate the isotopes based on the formula but place them at precursor_mz
-    std::vector<double> isotopes_int;
-    getIsotopeIntysFromExpSpec_(precursor_mz, spectrum, isotopes_int, sum_formula.getCharge());
+    std::vector<std::pair<double, double> > windows;
+    addIsotopeWindows_(precursor_mz, sum_formula.getCharge(), windows);
+    std::vector<double> window_mz, window_int;
+    integrateWindows_(spectrum, windows, window_mz, window_int);
+    std::vector<double> isotopes_int(window_int.begin(), window_int.begin() + static_cast<Size>(dia_nr_isotopes_) + 1);
 
     double max_ratio = 0;
     int nr_occurrences = 0;
@@ -216,42 +231,27 @@ namespace OpenMS
     // calculate the scores:
     // isotope correlation (forward) and the isotope overlap (backward) scores
     isotope_corr = scoreIsotopePattern_(isotopes_int, sum_formula);
-    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, isotopes_int[0], nr_occurrences, max_ratio);
+    largePeaksBeforeFirstIsotope_(window_mz, window_int, static_cast<Size>(dia_nr_isotopes_) + 1, precursor_mz, isotopes_int[0], nr_occurrences, max_ratio);
     isotope_overlap = max_ratio;
   }
 
-  void DIAScoring::getIsotopeIntysFromExpSpec_(double precursor_mz, SpectrumPtrType spectrum,
-                            std::vector<double>& isotopes_int,
-                            int charge_state) const
-  {
-    double abs_charge = std::fabs(static_cast<double>(charge_state));
-    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-    {
-      double left  = precursor_mz + iso * C13C12_MASSDIFF_U / abs_charge;
-      double right = left;
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      isotopes_int.push_back(intensity);
-    }
-  }
-
   void DIAScoring::dia_ms1_isotope_scores_averagine(double precursor_mz, SpectrumPtrType spectrum,
                                                     double& isotope_corr, double& isotope_overlap,
                                                     int charge_state) const
   {
-    std::vector<double> exp_isotopes_int;
-    getIsotopeIntysFromExpSpec_(precursor_mz, spectrum, exp_isotopes_int, charge_state);
-    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
-    // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
-    IsotopeDistribution isotope_dist = solver.estimateFromPeptideWeight(std::fabs(precursor_mz * charge_state));
+    std::vector<std::pair<double, double> > windows;
+    addIsotopeWindows_(precursor_mz, charge_state, windows);
+    std::vector<double> window_mz, window_int;
+    integrateWindows_(spectrum, windows, window_mz, window_int);
+    std::vector<double> exp_isotopes_int(window_int.begin(), window_int.begin() + static_cast<Size>(dia_nr_isotopes_) + 1);
 
     double max_ratio;
     int nr_occurrences;
     // calculate the scores:
     // isotope correlation (forward) and the isotope overlap (backward) scores
-    isotope_corr = scoreIsotopePattern_(exp_isotopes_int, isotope_dist);
-    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, exp_isotopes_int[0], nr_occurrences, max_ratio);
+    // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
+    isotope_corr = scoreIsotopePattern_(exp_isotopes_int, getAveragineIsotopes_(std::fabs(precursor_mz * charge_state)));
+    largePeaksBeforeFirstIsotope_(window_mz, window_int, static_cast<Size>(dia_nr_isotopes_) + 1, precursor_mz, exp_isotopes_int[0], nr_occurrences, max_ratio);
     isotope_overlap = max_ratio;
   }
 
@@ -263,33 +263,26 @@ namespace OpenMS
     yseries_score = 0;
     OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
 
-    double mz, intensity, left, right;
     std::vector<double> yseries, bseries;
     OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
-    for (const auto& b_ion_mz : bseries)
-    {
-      left = b_ion_mz;
-      right = b_ion_mz;
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
 
-      bool signalFound = DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      double ppmdiff = Math::getPPMAbs(mz, b_ion_mz);
-      if (signalFound && ppmdiff < dia_byseries_ppm_diff_ && intensity > dia_byseries_intensity_min_)
-      {
-        bseries_score++;
-      }
-    }
-    for (const auto& y_ion_mz : yseries)
-    {
-      left = y_ion_mz;
-      right = y_ion_mz;
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
+    // integrate b and y ions in one pass
+    std::vector<std::pair<double, double> > windows;
+    windows.reserve(bseries.size() + yseries.size());
+    for (const auto& ion_mz : bseries) addWindow_(ion_mz, windows);
+    for (const auto& ion_mz : yseries) addWindow_(ion_mz, windows);
+    std::vector<double> window_mz, window_int;
+    integrateWindows_(spectrum, windows, window_mz, window_int);
 
-      bool signalFound = DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      double ppmdiff = Math::getPPMAbs(mz, y_ion_mz);
-      if (signalFound && ppmdiff < dia_byseries_ppm_diff_ && intensity > dia_byseries_intensity_min_)
+    for (Size k = 0; k < windows.size(); ++k)
+    {
+      bool is_b_ion = k < bseries.size();
+      double ion_mz = is_b_ion ? bseries[k] : yseries[k - bseries.size()];
+      double ppmdiff = Math::getPPMAbs(window_mz[k], ion_mz);
+      if (window_int[k] > 0. && ppmdiff < dia_byseries_ppm_diff_ && window_int[k] > dia_byseries_intensity_min_)
       {
-        yseries_score++;
+        if (is_b_ion) bseries_score++;
+        else yseries_score++;
       }
     }
   }
@@ -322,60 +315,100 @@ namespace OpenMS
                                         double& isotope_corr,
                                         double& isotope_overlap) const
   {
+    // If no charge is given, we assume it to be 1
+    std::vector<int> putative_fragment_charges(transitions.size(), 1);
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      if (transitions[k].fragment_charge != 0)
+      {
+        putative_fragment_charges[k] = transitions[k].fragment_charge;
+      }
+    }
+
+    // collect the potential isotopes (and the peaks before them) of all
+    // transitions and integrate them in one pass over the spectrum
+    std::vector<std::pair<double, double> > windows;
+    windows.reserve(transitions.size() * nrIsotopeWindows_());
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      addIsotopeWindows_(transitions[k].getProductMZ(), putative_fragment_charges[k], windows);
+    }
+    std::vector<double> window_mz, window_int;
+    integrateWindows_(spectrum, windows, window_mz, window_int);
+
     std::vector<double> isotopes_int;
     double max_ratio;
     int nr_occurences;
     for (Size k = 0; k < transitions.size(); k++)
     {
-      isotopes_int.clear();
       const String native_id = transitions[k].getNativeID();
       double rel_intensity = intensities[native_id];
 
-      // If no charge is given, we assume it to be 1
-      int putative_fragment_charge = 1;
-      if (transitions[k].fragment_charge != 0)
-      {
-        putative_fragment_charge = transitions[k].fragment_charge;
-      }
-
-      // collect the potential isotopes of this peak
-      double abs_charge = std::fabs(static_cast<double>(putative_fragment_charge));
-      for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-      {
-        double left = transitions[k].getProductMZ() + iso * C13C12_MASSDIFF_U / abs_charge;
-        double right = left;
-        DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-        double mz, intensity;
-        DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-        isotopes_int.push_back(intensity);
-      }
+      Size offset = k * nrIsotopeWindows_();
+      isotopes_int.assign(window_int.begin() + offset, window_int.begin() + offset + static_cast<Size>(dia_nr_isotopes_) + 1);
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(isotopes_int, transitions[k].getProductMZ(), putative_fragment_charge);
+      double score = scoreIsotopePattern_(isotopes_int, transitions[k].getProductMZ(), putative_fragment_charges[k]);
       isotope_corr += score * rel_intensity;
-      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
+      largePeaksBeforeFirstIsotope_(window_mz, window_int, offset + static_cast<Size>(dia_nr_isotopes_) + 1,
+                                    transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
     }
   }
 
-  void DIAScoring::largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurences, double& max_ratio) const
+  void DIAScoring::addWindow_(double center, std::vector<std::pair<double, double> >& windows) const
+  {
+    double left = center;
+    double right = center;
+    DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
+    windows.emplace_back(left, right);
+  }
+
+  Size DIAScoring::nrIsotopeWindows_() const
+  {
+    return static_cast<Size>(dia_nr_isotopes_) + 1 + static_cast<Size>(dia_nr_charges_);
+  }
+
+  void DIAScoring::addIsotopeWindows_(double mono_mz, int charge, std::vector<std::pair<double, double> >& windows) const
+  {
+    double abs_charge = std::fabs(static_cast<double>(charge));
+    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
+    {
+      addWindow_(mono_mz + iso * C13C12_MASSDIFF_U / abs_charge, windows);
+    }
+    for (int ch = 1; ch <= dia_nr_charges_; ++ch)
+    {
+      addWindow_(mono_mz - C13C12_MASSDIFF_U / (double) ch, windows);
+    }
+  }
+
+  void DIAScoring::integrateWindows_(SpectrumPtrType spectrum, const std::vector<std::pair<double, double> >& windows,
+                                     std::vector<double>& mz, std::vector<double>& intensity) const
+  {
+    if (dia_centroided_)
+    {
+      // not implemented (see DIAHelpers::integrateWindow)
+      throw "Not implemented";
+    }
+    DIAHelpers::integrateWindows(spectrum, windows, mz, intensity);
+  }
+
+  void DIAScoring::largePeaksBeforeFirstIsotope_(const std::vector<double>& window_mz, const std::vector<double>& window_int, Size offset,
+                                                 double mono_mz, double mono_int, int& nr_occurences, double& max_ratio) const
   {
-    double mz, intensity;
     nr_occurences = 0;
     max_ratio = 0.0;
 
     for (int ch = 1; ch <= dia_nr_charges_; ++ch)
     {
       double center = mono_mz - C13C12_MASSDIFF_U / (double) ch;
-      double left = center;
-      double right = center;
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      bool signalFound = DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      double mz = window_mz[offset + ch - 1];
+      double intensity = window_int[offset + ch - 1];
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
-      if (!signalFound)
+      if (!(intensity > 0.))
       {
         continue;
       }
@@ -414,57 +447,72 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set to != 0"); // charge can be positive and negative
 
-    IsotopeDistribution isotope_dist;
-
     // create the theoretical distribution from the peptide weight
-    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
     // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
-    isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
-
-    return scoreIsotopePattern_(isotopes_int, isotope_dist);
+    return scoreIsotopePattern_(isotopes_int, getAveragineIsotopes_(std::fabs(product_mz * putative_fragment_charge)));
   } //end of dia_isotope_corr_sub
 
   double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
                                           const EmpiricalFormula& empf) const
   {
-    return scoreIsotopePattern_(isotopes_int,
-                                empf.getIsotopeDistribution(CoarseIsotopePatternGenerator(dia_nr_isotopes_ + 1)));
+    // explicit (precursor) formulas are hardly ever repeated, so they are not cached
+    return scoreIsotopePattern_(isotopes_int, computeIsotopes_(empf));
   }
 
-  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
-                                          const IsotopeDistribution& isotope_dist) const
+  const std::vector<double>& DIAScoring::getAveragineIsotopes_(double average_weight) const
   {
-    typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
+    // same estimate as CoarseIsotopePatternGenerator::estimateFromPeptideWeight
+    // (Senko's averagine), which only depends on the rounded element counts
+    EmpiricalFormula averagine;
+    averagine.estimateFromWeightAndComp(average_weight, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+    String key = averagine.toString();
+    {
+      std::lock_guard<std::mutex> lock(isotope_cache_mutex_);
+      auto pos = isotope_cache_.find(key);
+      if (pos != isotope_cache_.end())
+      {
+        return pos->second;
+      }
+    }
 
-    TheoreticalIsotopePattern isotopes;
+    // compute without holding the lock (entries are never removed while scoring, so references stay valid)
+    std::vector<double> intensities = computeIsotopes_(averagine);
+    std::lock_guard<std::mutex> lock(isotope_cache_mutex_);
+    return isotope_cache_.insert(std::make_pair(key, std::move(intensities))).first->second;
+  }
 
+  std::vector<double> DIAScoring::computeIsotopes_(const EmpiricalFormula& formula) const
+  {
+    IsotopeDistribution isotope_dist = formula.getIsotopeDistribution(CoarseIsotopePatternGenerator(dia_nr_isotopes_ + 1));
+    std::vector<double> intensities;
     for (IsotopeDistribution::ConstIterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
     {
-      isotopes.intensity.push_back(it->getIntensity());
+      intensities.push_back(it->getIntensity());
     }
-    isotopes.optional_begin = 0;
-    isotopes.optional_end = dia_nr_isotopes_;
 
     // scale the distribution to a maximum of 1
     double max = 0.0;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < intensities.size(); ++i)
     {
-      if (isotopes.intensity[i] > max)
+      if (intensities[i] > max)
       {
-        max = isotopes.intensity[i];
+        max = intensities[i];
       }
     }
-    isotopes.max = max;
     if (max == 0.) max = 1.;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < intensities.size(); ++i)
     {
-      isotopes.intensity[i] /= max;
+      intensities[i] /= max;
     }
-    isotopes.trimmed_left = 0;
+    return intensities;
+  }
 
+  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                          const std::vector<double>& theoretical_int) const
+  {
     // score the pattern against a theoretical one
-    OPENMS_POSTCONDITION(isotopes_int.size() == isotopes.intensity.size(), "Vectors for pearson correlation do not have the same size.");
-    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.intensity.begin());
+    OPENMS_POSTCONDITION(isotopes_int.size() == theoretical_int.size(), "Vectors for pearson correlation do not have the same size.");
+    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), theoretical_int.begin());
     if (boost::math::isnan(int_score))
     {
       int_score = 0;
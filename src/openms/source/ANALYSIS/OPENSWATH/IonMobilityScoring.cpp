@@ -161,25 +161,27 @@ namespace OpenMS
   }
 
   /**
-    @brief Integrate intensity in an ion mobility spectrum from start to end
+    @brief Integrate intensity in an ion mobility spectrum for several m/z windows
 
-    This function will integrate the intensity in a spectrum between mz_start
-    and mz_end, returning the total intensity and an intensity-weighted drift
-    time value.
+    This function will integrate the intensity in a spectrum between the
+    start and end of each m/z window, returning the total intensity and an
+    intensity-weighted drift time value per window. It also returns the full
+    ion mobility profile of each window in "res".
 
-    This function also returns the full ion mobility profile in "res".
+    All windows are extracted in a single forward pass through the spectrum:
+    the windows are visited in order of their start and the search for the
+    next window continues from the previous one.
 
-    @note If there is no signal, mz will be set to -1 and intensity to 0
+    @note If there is no signal in a window, its im will be set to -1 and its intensity to 0
   */
-  void integrateDriftSpectrum(OpenSwath::SpectrumPtr spectrum, 
-                              double mz_start,
-                              double mz_end,
-                              double & im,
-                              double & intensity,
-                              IonMobilogram& res, 
-                              double eps,
-                              double drift_start,
-                              double drift_end)
+  void extractMobilograms(const OpenSwath::SpectrumPtr& spectrum,
+                          const std::vector<std::pair<double, double> >& windows,
+                          std::vector<double>& im,
+                          std::vector<double>& intensity,
+                          std::vector<IonMobilogram>& res,
+                          double eps,
+                          double drift_start,
+                          double drift_end)
   {
     OPENMS_PRECONDITION(spectrum->getDriftTimeArray() != nullptr, "Cannot filter by drift time if no drift time is available.");
 
@@ -187,49 +189,67 @@ namespace OpenMS
     // TODO: how to improve this -- will work up to 42949.67296
     double IM_IDX_MULT = 1/eps;
 
+    im.assign(windows.size(), 0.0);
+    intensity.assign(windows.size(), 0.0);
+    res.assign(windows.size(), IonMobilogram());
+
+    std::vector<Size> order(windows.size());
+    for (Size i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+      [&windows](Size a, Size b) { return windows[a].first < windows[b].first; });
+
+    const auto& mz_arr = spectrum->getMZArray()->data;
+    const auto& int_arr = spectrum->getIntensityArray()->data;
+    const auto& im_arr = spectrum->getDriftTimeArray()->data;
+
     // We need to store all values that map to the same ion mobility in the
     // same spot in the ion mobilogram (they are not sorted by ion mobility in
-    // the input data), therefore create a map to map to bins.
-    std::map< int, double> im_chrom;
-    auto mz_arr_end = spectrum->getMZArray()->data.end();
-    auto int_it = spectrum->getIntensityArray()->data.begin();
-    auto im_it = spectrum->getDriftTimeArray()->data.begin();
+    // the input data), therefore collect (bin, intensity) pairs and merge
+    // them after a stable sort, which sums each bin in input order.
+    std::vector<std::pair<int, double> > im_chrom;
 
     // this assumes that the spectra are sorted!
-    auto mz_it = std::lower_bound(spectrum->getMZArray()->data.begin(), mz_arr_end, mz_start);
-    auto mz_it_end = std::lower_bound(mz_it, mz_arr_end, mz_end);
+    auto mz_begin = mz_arr.begin();
+    for (Size w : order)
+    {
+      mz_begin = std::lower_bound(mz_begin, mz_arr.end(), windows[w].first);
+      auto mz_it_end = std::lower_bound(mz_begin, mz_arr.end(), windows[w].second);
 
-    // also advance intensity and ion mobility iterator now
-    auto iterator_pos = std::distance(spectrum->getMZArray()->data.begin(), mz_it);
-    std::advance(int_it, iterator_pos);
-    std::advance(im_it, iterator_pos);
+      im_chrom.clear();
+      double& w_im = im[w];
+      double& w_intensity = intensity[w];
 
-    // Iterate from mz start to end, only storing ion mobility values that are in the range
-    for (; mz_it != mz_it_end; ++mz_it, ++int_it, ++im_it)
-    {
-      if ( *im_it >= drift_start && *im_it <= drift_end)
+      // Iterate from mz start to end, only storing ion mobility values that are in the range
+      for (Size i = mz_begin - mz_arr.begin(); i < Size(mz_it_end - mz_arr.begin()); ++i)
       {
-        // std::cout << "IM " << *im_it << " mz " << *mz_it << " int " << *int_it << std::endl;
-        im_chrom[ int((*im_it)*IM_IDX_MULT) ] += *int_it;
-        intensity += (*int_it);
-        im += (*int_it) * (*im_it);
+        if (im_arr[i] >= drift_start && im_arr[i] <= drift_end)
+        {
+          im_chrom.emplace_back(int(im_arr[i] * IM_IDX_MULT), int_arr[i]);
+          w_intensity += int_arr[i];
+          w_im += int_arr[i] * im_arr[i];
+        }
       }
-    }
 
-    if (intensity > 0.)
-    {
-      im /= intensity;
-    }
-    else
-    {
-      im = -1;
-      intensity = 0;
-    }
+      if (w_intensity > 0.)
+      {
+        w_im /= w_intensity;
+      }
+      else
+      {
+        w_im = -1;
+        w_intensity = 0;
+      }
 
-    res.reserve(res.size() + im_chrom.size());
-    for (const auto& k : im_chrom)
-    {
-      res.emplace_back(k.first / IM_IDX_MULT, k.second );
+      std::stable_sort(im_chrom.begin(), im_chrom.end(),
+        [](const std::pair<int, double>& a, const std::pair<int, double>& b) { return a.first < b.first; });
+      IonMobilogram& profile = res[w];
+      for (Size k = 0; k < im_chrom.size(); )
+      {
+        const int bin = im_chrom[k].first;
+        double bin_intensity = 0.0;
+        for (; k < im_chrom.size() && im_chrom[k].first == bin; ++k) bin_intensity += im_chrom[k].second;
+        profile.emplace_back(bin / IM_IDX_MULT, bin_intensity);
+      }
     }
   }
 
@@ -268,27 +288,25 @@ namespace OpenMS
     double drift_upper_used = drift_upper + drift_width * drift_extra;
 
     std::vector< IonMobilogram > mobilograms;
+    std::vector<double> im, intensity;
 
-    // Step 1: MS2 extraction
-    for (std::size_t k = 0; k < transitions.size(); k++)
+    // Step 1: MS2 extraction (all transitions in one pass)
+    std::vector<std::pair<double, double> > windows;
+    windows.reserve(transitions.size());
+    for (const auto& transition : transitions)
     {
-      double im(0), intensity(0);
-      IonMobilogram res;
-      const TransitionType transition = transitions[k];
-      // Calculate the difference of the theoretical ion mobility and the actually measured ion mobility
       double left(transition.getProductMZ()), right(transition.getProductMZ());
       DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-
-      integrateDriftSpectrum(spectrum, left, right, im, intensity, res, eps, drift_lower_used, drift_upper_used);
-      mobilograms.push_back( std::move(res) );
+      windows.emplace_back(left, right);
     }
+    extractMobilograms(spectrum, windows, im, intensity, mobilograms, eps, drift_lower_used, drift_upper_used);
 
     // Step 2: MS1 extraction
-    double im(0), intensity(0);
-    IonMobilogram ms1_profile;
+    std::vector< IonMobilogram > ms1_profiles;
     double left(transitions[0].getPrecursorMZ()), right(transitions[0].getPrecursorMZ());
     DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-    integrateDriftSpectrum(ms1spectrum, left, right, im, intensity, ms1_profile, eps, drift_lower_used, drift_upper_used); // TODO: aggregate over isotopes
+    extractMobilograms(ms1spectrum, {{left, right}}, im, intensity, ms1_profiles, eps, drift_lower_used, drift_upper_used); // TODO: aggregate over isotopes
+    const IonMobilogram ms1_profile = ms1_profiles[0];
     mobilograms.push_back(ms1_profile);
 
     std::vector<double> im_grid = computeGrid(mobilograms, eps); // ensure grid is based on all profiles!
@@ -405,18 +423,23 @@ namespace OpenMS
     double sum_intensity = 0;
     int tr_used = 0;
 
-    // Step 1: MS2 extraction
-    for (std::size_t k = 0; k < transitions.size(); k++)
+    // Step 1: MS2 extraction (all transitions in one pass)
+    std::vector<std::pair<double, double> > windows;
+    windows.reserve(transitions.size());
+    for (const auto& transition : transitions)
     {
-      const TransitionType transition = transitions[k];
-      IonMobilogram res;
-      double im(0), intensity(0);
-
-      // Calculate the difference of the theoretical ion mobility and the actually measured ion mobility
       double left(transition.getProductMZ()), right(transition.getProductMZ());
       DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      integrateDriftSpectrum(spectrum, left, right, im, intensity, res, eps, drift_lower_used, drift_upper_used);
-      mobilograms.push_back(res);
+      windows.emplace_back(left, right);
+    }
+    std::vector<double> extracted_im, extracted_intensity;
+    extractMobilograms(spectrum, windows, extracted_im, extracted_intensity, mobilograms, eps, drift_lower_used, drift_upper_used);
+
+    for (std::size_t k = 0; k < transitions.size(); k++)
+    {
+      // Calculate the difference of the theoretical ion mobility and the actually measured ion mobility
+      const double im = extracted_im[k];
+      const double intensity = extracted_intensity[k];
 
       // TODO what do to about those that have no signal ?
       if (intensity <= 0.0) {continue;} // note: im is -1 then
@@ -85,7 +85,8 @@ namespace OpenMS
 
   MRMFeatureFinderScoring::MRMFeatureFinderScoring() :
     DefaultParamHandler("MRMFeatureFinderScoring"),
-    ProgressLogger()
+    ProgressLogger(),
+    spectrum_cache_(new SummedSpectrumCache())
   {
     defaults_.setValue("stop_report_after_feature", -1, "Stop reporting after feature (ordered by quality; -1 means do not stop).");
     defaults_.setValue("rt_extraction_window", -1.0, "Only extract RT around this value (-1 means extract over the whole range, a value of 500 means to extract around +/- 500 s of the expected elution). For this to work, the TraML input file needs to contain normalized RT values.");
@@ -198,6 +199,9 @@ namespace OpenMS
     // Store the peptide retention times in an intermediate map
     prepareProteinPeptideMaps_(transition_exp);
 
+    // cached spectra are only valid for the current spectrum maps
+    spectrum_cache_->clear();
+
     // Store the proteins from the input in the output feature map
     std::vector<ProteinHit> protein_hits;
     for (const ProteinType& prot : transition_exp.getProteins())
@@ -545,6 +549,7 @@ namespace OpenMS
                       im_extra_drift_,
                       su_,
                       spectrum_addition_method_);
+    scorer.setSpectrumCache(spectrum_cache_.get());
 
     ProteaseDigestion pd;
     pd.setEnzyme("Trypsin");
@@ -1027,6 +1032,7 @@ namespace OpenMS
     uis_threshold_sn_ = param_.getValue("uis_threshold_sn");
     uis_threshold_peak_area_ = param_.getValue("uis_threshold_peak_area");
     scoring_model_ = param_.getValue("scoring_model");
+    spectrum_cache_->clear(); // spectra depend on the addition parameters
 
     sn_win_len_ = (double)param_.getValue("TransitionGroupPicker:PeakPickerMRM:sn_win_len");
     sn_bin_count_ = (unsigned int)param_.getValue("TransitionGroupPicker:PeakPickerMRM:sn_bin_count");
@@ -34,10 +34,13 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
 
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
 #include <sqlite3.h>
 
+#include <cmath>
+
 namespace OpenMS
 {
   OpenSwathOSWWriter::OpenSwathOSWWriter(const String& output_filename, const UInt64 run_id, const String& input_filename, bool ms1_scores, bool sonar, bool uis_scores) :
@@ -222,12 +225,338 @@ namespace OpenMS
     return separated_scores;
   }
 
-  String OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& /* pep */,
-                                         const OpenSwath::LightTransition* /* transition */,
-                                         const FeatureMap& output,
-                                         const String& id) const
+  namespace
   {
-    std::stringstream sql, sql_feature, sql_feature_ms1, sql_feature_ms1_precursor, sql_feature_ms2, sql_feature_ms2_transition, sql_feature_uis_transition;
+    typedef OpenSwathOSWWriter::OSWRows::Value OSWValue;
+
+    /// Column name and the meta value it is filled from
+    typedef std::pair<const char*, const char*> ScoreColumn;
+
+    const std::vector<String>& featureColumns()
+    {
+      static const std::vector<String> columns = {"ID", "RUN_ID", "PRECURSOR_ID", "EXP_RT", "EXP_IM", "NORM_RT", "DELTA_RT", "LEFT_WIDTH", "RIGHT_WIDTH"};
+      return columns;
+    }
+
+    const std::vector<String>& featurePrecursorColumns()
+    {
+      static const std::vector<String> columns = {"FEATURE_ID", "ISOTOPE", "AREA_INTENSITY", "APEX_INTENSITY"};
+      return columns;
+    }
+
+    const std::vector<String>& featureTransitionColumns()
+    {
+      static const std::vector<String> columns = {"FEATURE_ID", "TRANSITION_ID", "AREA_INTENSITY", "TOTAL_AREA_INTENSITY", "APEX_INTENSITY", "TOTAL_MI"};
+      return columns;
+    }
+
+    // FEATURE_MS2 columns after FEATURE_ID and AREA_INTENSITY
+    const std::vector<ScoreColumn>& featureMS2Scores()
+    {
+      static const std::vector<ScoreColumn> scores = {
+        {"TOTAL_AREA_INTENSITY", "total_xic"},
+        {"APEX_INTENSITY", "peak_apices_sum"},
+        {"TOTAL_MI", "total_mi"},
+        {"VAR_BSERIES_SCORE", "var_bseries_score"},
+        {"VAR_DOTPROD_SCORE", "var_dotprod_score"},
+        {"VAR_INTENSITY_SCORE", "var_intensity_score"},
+        {"VAR_ISOTOPE_CORRELATION_SCORE", "var_isotope_correlation_score"},
+        {"VAR_ISOTOPE_OVERLAP_SCORE", "var_isotope_overlap_score"},
+        {"VAR_LIBRARY_CORR", "var_library_corr"},
+        {"VAR_LIBRARY_DOTPROD", "var_library_dotprod"},
+        {"VAR_LIBRARY_MANHATTAN", "var_library_manhattan"},
+        {"VAR_LIBRARY_RMSD", "var_library_rmsd"},
+        {"VAR_LIBRARY_ROOTMEANSQUARE", "var_library_rootmeansquare"},
+        {"VAR_LIBRARY_SANGLE", "var_library_sangle"},
+        {"VAR_LOG_SN_SCORE", "var_log_sn_score"},
+        {"VAR_MANHATTAN_SCORE", "var_manhatt_score"},
+        {"VAR_MASSDEV_SCORE", "var_massdev_score"},
+        {"VAR_MASSDEV_SCORE_WEIGHTED", "var_massdev_score_weighted"},
+        {"VAR_MI_SCORE", "var_mi_score"},
+        {"VAR_MI_WEIGHTED_SCORE", "var_mi_weighted_score"},
+        {"VAR_MI_RATIO_SCORE", "var_mi_ratio_score"},
+        {"VAR_NORM_RT_SCORE", "var_norm_rt_score"},
+        {"VAR_XCORR_COELUTION", "var_xcorr_coelution"},
+        {"VAR_XCORR_COELUTION_WEIGHTED", "var_xcorr_coelution_weighted"},
+        {"VAR_XCORR_SHAPE", "var_xcorr_shape"},
+        {"VAR_XCORR_SHAPE_WEIGHTED", "var_xcorr_shape_weighted"},
+        {"VAR_YSERIES_SCORE", "var_yseries_score"},
+        {"VAR_ELUTION_MODEL_FIT_SCORE", "var_elution_model_fit_score"},
+        {"VAR_IM_XCORR_SHAPE", "var_im_xcorr_shape"},
+        {"VAR_IM_XCORR_COELUTION", "var_im_xcorr_coelution"},
+        {"VAR_IM_DELTA_SCORE", "var_im_delta_score"},
+        {"VAR_SONAR_LAG", "var_sonar_lag"},
+        {"VAR_SONAR_SHAPE", "var_sonar_shape"},
+        {"VAR_SONAR_LOG_SN", "var_sonar_log_sn"},
+        {"VAR_SONAR_LOG_DIFF", "var_sonar_log_diff"},
+        {"VAR_SONAR_LOG_TREND", "var_sonar_log_trend"},
+        {"VAR_SONAR_RSQ", "var_sonar_rsq"}
+      };
+      return scores;
+    }
+
+    // FEATURE_MS1 columns after FEATURE_ID
+    const std::vector<ScoreColumn>& featureMS1Scores()
+    {
+      static const std::vector<ScoreColumn> scores = {
+        {"AREA_INTENSITY", "ms1_area_intensity"},
+        {"APEX_INTENSITY", "ms1_apex_intensity"},
+        {"VAR_MASSDEV_SCORE", "var_ms1_ppm_diff"},
+        {"VAR_IM_MS1_DELTA_SCORE", "var_im_ms1_delta_score"},
+        {"VAR_MI_SCORE", "var_ms1_mi_score"},
+        {"VAR_MI_CONTRAST_SCORE", "var_ms1_mi_contrast_score"},
+        {"VAR_MI_COMBINED_SCORE", "var_ms1_mi_combined_score"},
+        {"VAR_ISOTOPE_CORRELATION_SCORE", "var_ms1_isotope_correlation"},
+        {"VAR_ISOTOPE_OVERLAP_SCORE", "var_ms1_isotope_overlap"},
+        {"VAR_XCORR_COELUTION", "var_ms1_xcorr_coelution"},
+        {"VAR_XCORR_COELUTION_CONTRAST", "var_ms1_xcorr_coelution_contrast"},
+        {"VAR_XCORR_COELUTION_COMBINED", "var_ms1_xcorr_coelution_combined"},
+        {"VAR_XCORR_SHAPE", "var_ms1_xcorr_shape"},
+        {"VAR_XCORR_SHAPE_CONTRAST", "var_ms1_xcorr_shape_contrast"},
+        {"VAR_XCORR_SHAPE_COMBINED", "var_ms1_xcorr_shape_combined"}
+      };
+      return scores;
+    }
+
+    // FEATURE_TRANSITION columns (after FEATURE_ID) for UIS scoring, the meta
+    // values are prefixed with "id_target_" or "id_decoy_"
+    const std::vector<ScoreColumn>& featureTransitionUISScores()
+    {
+      static const std::vector<ScoreColumn> scores = {
+        {"TRANSITION_ID", "transition_names"},
+        {"AREA_INTENSITY", "area_intensity"},
+        {"TOTAL_AREA_INTENSITY", "total_area_intensity"},
+        {"APEX_INTENSITY", "apex_intensity"},
+        {"TOTAL_MI", "total_mi"},
+        {"VAR_INTENSITY_SCORE", "intensity_score"},
+        {"VAR_INTENSITY_RATIO_SCORE", "intensity_ratio_score"},
+        {"VAR_LOG_INTENSITY", "ind_log_intensity"},
+        {"VAR_XCORR_COELUTION", "ind_xcorr_coelution"},
+        {"VAR_XCORR_SHAPE", "ind_xcorr_shape"},
+        {"VAR_LOG_SN_SCORE", "ind_log_sn_score"},
+        {"VAR_MASSDEV_SCORE", "ind_massdev_score"},
+        {"VAR_MI_SCORE", "ind_mi_score"},
+        {"VAR_MI_RATIO_SCORE", "ind_mi_ratio_score"},
+        {"VAR_ISOTOPE_CORRELATION_SCORE", "ind_isotope_correlation"},
+        {"VAR_ISOTOPE_OVERLAP_SCORE", "ind_isotope_overlap"}
+      };
+      return scores;
+    }
+
+    std::vector<String> withFeatureId(const std::vector<ScoreColumn>& scores, bool area_intensity)
+    {
+      std::vector<String> columns;
+      columns.push_back("FEATURE_ID");
+      if (area_intensity) columns.push_back("AREA_INTENSITY");
+      for (const auto& score : scores) columns.push_back(score.first);
+      return columns;
+    }
+
+    const std::vector<String>& featureMS2Columns()
+    {
+      static const std::vector<String> columns = withFeatureId(featureMS2Scores(), true);
+      return columns;
+    }
+
+    const std::vector<String>& featureMS1Columns()
+    {
+      static const std::vector<String> columns = withFeatureId(featureMS1Scores(), false);
+      return columns;
+    }
+
+    const std::vector<String>& featureTransitionUISColumns()
+    {
+      static const std::vector<String> columns = withFeatureId(featureTransitionUISScores(), false);
+      return columns;
+    }
+
+    void addNull(std::vector<OSWValue>& table)
+    {
+      table.emplace_back();
+    }
+
+    void addInt(std::vector<OSWValue>& table, Int64 value)
+    {
+      OSWValue v;
+      v.type = OSWValue::INT_VALUE;
+      v.int_value = value;
+      table.push_back(v);
+    }
+
+    void addReal(std::vector<OSWValue>& table, double value)
+    {
+      if (std::isnan(value))
+      {
+        addNull(table);
+        return;
+      }
+      OSWValue v;
+      v.type = OSWValue::REAL_VALUE;
+      v.real_value = value;
+      table.push_back(v);
+    }
+
+    // text is stored as is; SQLite converts it according to the column affinity
+    void addText(std::vector<OSWValue>& table, std::vector<String>& texts, const String& value)
+    {
+      String lower(value);
+      lower.toLower();
+      if (lower == "nan" || lower == "-nan")
+      {
+        addNull(table);
+        return;
+      }
+      OSWValue v;
+      v.type = OSWValue::TEXT_VALUE;
+      v.int_value = (Int64)texts.size();
+      texts.push_back(value);
+      table.push_back(v);
+    }
+
+    void addDataValue(std::vector<OSWValue>& table, std::vector<String>& texts, const DataValue& value)
+    {
+      switch (value.valueType())
+      {
+        case DataValue::EMPTY_VALUE:
+          addNull(table);
+          break;
+        case DataValue::INT_VALUE:
+          addInt(table, (long long)value);
+          break;
+        case DataValue::DOUBLE_VALUE:
+          addReal(table, (double)value);
+          break;
+        default:
+          addText(table, texts, value.toString());
+      }
+    }
+
+    /// SQL literal of a value (as formatted by prepareLine)
+    String toSQLLiteral(const OSWValue& value, const std::vector<String>& texts)
+    {
+      switch (value.type)
+      {
+        case OSWValue::INT_VALUE:
+          return String(value.int_value);
+        case OSWValue::REAL_VALUE:
+          return String(value.real_value);
+        case OSWValue::TEXT_VALUE:
+          return texts[value.int_value];
+        default:
+          return "NULL";
+      }
+    }
+
+    void appendInsertStatements(std::stringstream& sql, const String& table, const std::vector<String>& columns,
+                                const std::vector<OSWValue>& values, const std::vector<String>& texts)
+    {
+      const String prefix = "INSERT INTO " + table + " (" + ListUtils::concatenate(columns, ", ") + ") VALUES (";
+      for (Size row_start = 0; row_start < values.size(); row_start += columns.size())
+      {
+        sql << prefix;
+        for (Size c = 0; c < columns.size(); ++c)
+        {
+          if (c > 0) sql << ", ";
+          sql << toSQLLiteral(values[row_start + c], texts);
+        }
+        sql << "); ";
+      }
+    }
+
+    void insertRows(sqlite3* db, const String& table, const std::vector<String>& columns,
+                    const std::vector<OSWValue>& values, const std::vector<String>& texts)
+    {
+      if (values.empty()) return;
+
+      std::vector<String> placeholders(columns.size(), "?");
+      const String insert_sql = "INSERT INTO " + table + " (" + ListUtils::concatenate(columns, ", ") + ") VALUES (" +
+                                ListUtils::concatenate(placeholders, ", ") + ")";
+      sqlite3_stmt* stmt = nullptr;
+      SqliteConnector::prepareStatement(db, &stmt, insert_sql);
+
+      for (Size row_start = 0; row_start < values.size(); row_start += columns.size())
+      {
+        int rc = SQLITE_OK;
+        for (Size c = 0; c < columns.size() && rc == SQLITE_OK; ++c)
+        {
+          const OSWValue& v = values[row_start + c];
+          const int pos = (int)c + 1;
+          switch (v.type)
+          {
+            case OSWValue::INT_VALUE:
+              rc = sqlite3_bind_int64(stmt, pos, v.int_value);
+              break;
+            case OSWValue::REAL_VALUE:
+              rc = sqlite3_bind_double(stmt, pos, v.real_value);
+              break;
+            case OSWValue::TEXT_VALUE:
+              // SQLITE_STATIC: the texts outlive the statement
+              rc = sqlite3_bind_text(stmt, pos, texts[v.int_value].c_str(), (int)texts[v.int_value].size(), SQLITE_STATIC);
+              break;
+            default:
+              rc = sqlite3_bind_null(stmt, pos);
+          }
+        }
+        if (rc == SQLITE_OK && sqlite3_step(stmt) != SQLITE_DONE)
+        {
+          rc = SQLITE_ERROR;
+        }
+        if (rc != SQLITE_OK)
+        {
+          String error = sqlite3_errmsg(db);
+          sqlite3_finalize(stmt);
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Could not insert into " + table + ": " + error);
+        }
+        sqlite3_reset(stmt);
+      }
+      sqlite3_finalize(stmt);
+    }
+  }
+
+  bool OpenSwathOSWWriter::OSWRows::empty() const
+  {
+    return feature.empty() && feature_ms1.empty() && feature_precursor.empty() &&
+           feature_ms2.empty() && feature_transition.empty() && feature_transition_uis.empty();
+  }
+
+  void OpenSwathOSWWriter::OSWRows::clear()
+  {
+    feature.clear();
+    feature_ms1.clear();
+    feature_precursor.clear();
+    feature_ms2.clear();
+    feature_transition.clear();
+    feature_transition_uis.clear();
+    texts.clear();
+  }
+
+  void OpenSwathOSWWriter::OSWRows::append(const OSWRows& other)
+  {
+    const Int64 text_offset = (Int64)texts.size();
+    texts.insert(texts.end(), other.texts.begin(), other.texts.end());
+
+    auto append_table = [text_offset](std::vector<Value>& dst, const std::vector<Value>& src)
+    {
+      const Size start = dst.size();
+      dst.insert(dst.end(), src.begin(), src.end());
+      for (Size i = start; i < dst.size(); ++i)
+      {
+        if (dst[i].type == Value::TEXT_VALUE) dst[i].int_value += text_offset;
+      }
+    };
+    append_table(feature, other.feature);
+    append_table(feature_ms1, other.feature_ms1);
+    append_table(feature_precursor, other.feature_precursor);
+    append_table(feature_ms2, other.feature_ms2);
+    append_table(feature_transition, other.feature_transition);
+    append_table(feature_transition_uis, other.feature_transition_uis);
+  }
+
+  void OpenSwathOSWWriter::prepareRows(const FeatureMap& output, const String& id, OSWRows& rows) const
+  {
+    std::vector<String>& texts = rows.texts;
+    const Size transitions_start = rows.feature_transition.size();
+    const Size uis_transitions_start = rows.feature_transition_uis.size();
 
     for (const auto& feature_it : output)
     {
@@ -237,29 +566,21 @@ namespace OpenMS
       {
         if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS2")
         {
-          std::string total_mi = "NULL"; // total_mi is not guaranteed to be set
-          if (!sub_it.getMetaValue("total_mi").isEmpty())
-          {
-            total_mi = sub_it.getMetaValue("total_mi").toString();
-          }
-          sql_feature_ms2_transition  << "INSERT INTO FEATURE_TRANSITION "\
-            "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI) VALUES ("
-                                      << feature_id << ", "
-                                      << sub_it.getMetaValue("native_id") << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("total_xic") << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << ", "
-                                      << total_mi << "); ";
+          addInt(rows.feature_transition, feature_id);
+          addText(rows.feature_transition, texts, sub_it.getMetaValue("native_id").toString());
+          addReal(rows.feature_transition, sub_it.getIntensity());
+          addDataValue(rows.feature_transition, texts, sub_it.getMetaValue("total_xic"));
+          addDataValue(rows.feature_transition, texts, sub_it.getMetaValue("peak_apex_int"));
+          addDataValue(rows.feature_transition, texts, sub_it.getMetaValue("total_mi")); // total_mi is not guaranteed to be set
         }
         else if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS1" && sub_it.getIntensity() > 0.0)
         {
           std::vector<String> precursor_id;
           OpenMS::String(sub_it.getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), precursor_id);
-          sql_feature_ms1_precursor  << "INSERT INTO FEATURE_PRECURSOR (FEATURE_ID, ISOTOPE, AREA_INTENSITY, APEX_INTENSITY) VALUES ("
-                                      << feature_id << ", "
-                                      << precursor_id[1] << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << "); ";
+          addInt(rows.feature_precursor, feature_id);
+          addText(rows.feature_precursor, texts, precursor_id[1]);
+          addReal(rows.feature_precursor, sub_it.getIntensity());
+          addDataValue(rows.feature_precursor, texts, sub_it.getMetaValue("peak_apex_int"));
         }
       }
 
@@ -268,209 +589,86 @@ namespace OpenMS
       if (feature_it.metaValueExists("norm_RT") ) norm_rt = feature_it.getMetaValue("norm_RT");
       if (feature_it.metaValueExists("delta_rt") ) delta_rt = feature_it.getMetaValue("delta_rt");
 
-      sql_feature << "INSERT INTO FEATURE (ID, RUN_ID, PRECURSOR_ID, EXP_RT, EXP_IM, NORM_RT, DELTA_RT, LEFT_WIDTH, RIGHT_WIDTH) VALUES ("
-                  << feature_id << ", "
-                  << run_id_ << ", "
-                  << id << ", "
-                  << feature_it.getRT() << ", "
-                  << getScore(feature_it, "im_drift") << ", "
-                  << norm_rt << ", "
-                  << delta_rt << ", "
-                  << feature_it.getMetaValue("leftWidth") << ", "
-                  << feature_it.getMetaValue("rightWidth") << "); ";
-
-      sql_feature_ms2 << "INSERT INTO FEATURE_MS2 " \
-        "(FEATURE_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, "\
-        "VAR_BSERIES_SCORE, VAR_DOTPROD_SCORE, VAR_INTENSITY_SCORE, " \
-        "VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_LIBRARY_CORR,  "\
-        "VAR_LIBRARY_DOTPROD, VAR_LIBRARY_MANHATTAN, VAR_LIBRARY_RMSD, VAR_LIBRARY_ROOTMEANSQUARE, "\
-        "VAR_LIBRARY_SANGLE, VAR_LOG_SN_SCORE, VAR_MANHATTAN_SCORE, VAR_MASSDEV_SCORE, VAR_MASSDEV_SCORE_WEIGHTED, "\
-        "VAR_MI_SCORE, VAR_MI_WEIGHTED_SCORE, VAR_MI_RATIO_SCORE, VAR_NORM_RT_SCORE, "\
-        "VAR_XCORR_COELUTION,VAR_XCORR_COELUTION_WEIGHTED, VAR_XCORR_SHAPE, "\
-        "VAR_XCORR_SHAPE_WEIGHTED, VAR_YSERIES_SCORE, VAR_ELUTION_MODEL_FIT_SCORE, "\
-        "VAR_IM_XCORR_SHAPE, VAR_IM_XCORR_COELUTION, VAR_IM_DELTA_SCORE, " \
-        "VAR_SONAR_LAG, VAR_SONAR_SHAPE, VAR_SONAR_LOG_SN, VAR_SONAR_LOG_DIFF, VAR_SONAR_LOG_TREND, VAR_SONAR_RSQ "\
-        ") VALUES ("
-                      << feature_id << ", "
-                      << feature_it.getIntensity() << ", "
-                      << getScore(feature_it, "total_xic") << ", "
-                      << getScore(feature_it, "peak_apices_sum") << ", "
-                      << getScore(feature_it, "total_mi") << ", "
-                      << getScore(feature_it, "var_bseries_score") << ", "
-                      << getScore(feature_it, "var_dotprod_score") << ", "
-                      << getScore(feature_it, "var_intensity_score") << ", "
-                      << getScore(feature_it, "var_isotope_correlation_score") << ", "
-                      << getScore(feature_it, "var_isotope_overlap_score") << ", "
-                      << getScore(feature_it, "var_library_corr") << ", "
-                      << getScore(feature_it, "var_library_dotprod") << ", "
-                      << getScore(feature_it, "var_library_manhattan") << ", "
-                      << getScore(feature_it, "var_library_rmsd") << ", "
-                      << getScore(feature_it, "var_library_rootmeansquare") << ", "
-                      << getScore(feature_it, "var_library_sangle") << ", "
-                      << getScore(feature_it, "var_log_sn_score") << ", "
-                      << getScore(feature_it, "var_manhatt_score") << ", "
-                      << getScore(feature_it, "var_massdev_score") << ", "
-                      << getScore(feature_it, "var_massdev_score_weighted") << ", "
-                      << getScore(feature_it, "var_mi_score") << ", "
-                      << getScore(feature_it, "var_mi_weighted_score") << ", "
-                      << getScore(feature_it, "var_mi_ratio_score") << ", "
-                      << getScore(feature_it, "var_norm_rt_score") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution_weighted") << ", "
-                      << getScore(feature_it, "var_xcorr_shape") << ", "
-                      << getScore(feature_it, "var_xcorr_shape_weighted") << ", "
-                      << getScore(feature_it, "var_yseries_score") << ", "
-                      << getScore(feature_it, "var_elution_model_fit_score") << ", "
-                      << getScore(feature_it, "var_im_xcorr_shape") << ", "
-                      << getScore(feature_it, "var_im_xcorr_coelution") << ", "
-                      << getScore(feature_it, "var_im_delta_score") << ", "
-                      << getScore(feature_it, "var_sonar_lag") << ", "
-                      << getScore(feature_it, "var_sonar_shape") << ", "
-                      << getScore(feature_it, "var_sonar_log_sn") << ", "
-                      << getScore(feature_it, "var_sonar_log_diff") << ", "
-                      << getScore(feature_it, "var_sonar_log_trend") << ", "
-                      << getScore(feature_it, "var_sonar_rsq") << "); ";
+      addInt(rows.feature, feature_id);
+      addInt(rows.feature, (Int64)run_id_);
+      addText(rows.feature, texts, id);
+      addReal(rows.feature, feature_it.getRT());
+      addDataValue(rows.feature, texts, feature_it.getMetaValue("im_drift"));
+      addReal(rows.feature, norm_rt);
+      addReal(rows.feature, delta_rt);
+      addDataValue(rows.feature, texts, feature_it.getMetaValue("leftWidth"));
+      addDataValue(rows.feature, texts, feature_it.getMetaValue("rightWidth"));
+
+      addInt(rows.feature_ms2, feature_id);
+      addReal(rows.feature_ms2, feature_it.getIntensity());
+      for (const auto& score : featureMS2Scores())
+      {
+        addDataValue(rows.feature_ms2, texts, feature_it.getMetaValue(score.second));
+      }
 
       if (use_ms1_traces_)
       {
-        sql_feature_ms1 << "INSERT INTO FEATURE_MS1 "\
-          "(FEATURE_ID, AREA_INTENSITY, APEX_INTENSITY, "\
-          " VAR_MASSDEV_SCORE, VAR_IM_MS1_DELTA_SCORE, "\
-          " VAR_MI_SCORE, VAR_MI_CONTRAST_SCORE, VAR_MI_COMBINED_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, "\
-          " VAR_ISOTOPE_OVERLAP_SCORE, VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_CONTRAST, "\
-          " VAR_XCORR_COELUTION_COMBINED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_CONTRAST, VAR_XCORR_SHAPE_COMBINED "\
-          ") VALUES ("
-                        << feature_id << ", "
-                        << getScore(feature_it, "ms1_area_intensity") << ", "
-                        << getScore(feature_it, "ms1_apex_intensity") << ", "
-                        << getScore(feature_it, "var_ms1_ppm_diff") << ", "
-                        << getScore(feature_it, "var_im_ms1_delta_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_contrast_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_combined_score") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_correlation") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_overlap") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_combined") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_combined") << "); ";
+        addInt(rows.feature_ms1, feature_id);
+        for (const auto& score : featureMS1Scores())
+        {
+          addDataValue(rows.feature_ms1, texts, feature_it.getMetaValue(score.second));
+        }
       }
 
       if (enable_uis_scoring_)
       {
-        auto id_target_transition_names = getSeparateScore(feature_it, "id_target_transition_names");
-        auto id_target_area_intensity = getSeparateScore(feature_it, "id_target_area_intensity");
-        auto id_target_total_area_intensity = getSeparateScore(feature_it, "id_target_total_area_intensity");
-        auto id_target_apex_intensity = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_total_mi = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_intensity_score = getSeparateScore(feature_it, "id_target_intensity_score");
-        auto id_target_intensity_ratio_score = getSeparateScore(feature_it, "id_target_intensity_ratio_score");
-        auto id_target_log_intensity = getSeparateScore(feature_it, "id_target_ind_log_intensity");
-        auto id_target_ind_xcorr_coelution = getSeparateScore(feature_it, "id_target_ind_xcorr_coelution");
-        auto id_target_ind_xcorr_shape = getSeparateScore(feature_it, "id_target_ind_xcorr_shape");
-        auto id_target_ind_log_sn_score = getSeparateScore(feature_it, "id_target_ind_log_sn_score");
-        auto id_target_ind_massdev_score = getSeparateScore(feature_it, "id_target_ind_massdev_score");
-        auto id_target_ind_mi_score = getSeparateScore(feature_it, "id_target_ind_mi_score");
-        auto id_target_ind_mi_ratio_score = getSeparateScore(feature_it, "id_target_ind_mi_ratio_score");
-        auto id_target_ind_isotope_correlation = getSeparateScore(feature_it, "id_target_ind_isotope_correlation");
-        auto id_target_ind_isotope_overlap = getSeparateScore(feature_it, "id_target_ind_isotope_overlap");
-
-        if (feature_it.metaValueExists("id_target_num_transitions"))
+        for (const String prefix : {"id_target_", "id_decoy_"})
         {
-          int id_target_num_transitions = feature_it.getMetaValue("id_target_num_transitions");
+          if (!feature_it.metaValueExists(prefix + "num_transitions")) continue;
 
-          for (int i = 0; i < id_target_num_transitions; ++i)
+          std::vector< std::vector<String> > separate_scores;
+          for (const auto& score : featureTransitionUISScores())
           {
-            sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-              "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-              " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-              " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-              " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-              " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE "\
-              ") VALUES ("
-                                        << feature_id << ", "
-                                        << id_target_transition_names[i] << ", "
-                                        << id_target_area_intensity[i] << ", "
-                                        << id_target_total_area_intensity[i] << ", "
-                                        << id_target_apex_intensity[i] << ", "
-                                        << id_target_total_mi[i] << ", "
-                                        << id_target_intensity_score[i] << ", "
-                                        << id_target_intensity_ratio_score[i] << ", "
-                                        << id_target_log_intensity[i] << ", "
-                                        << id_target_ind_xcorr_coelution[i] << ", "
-                                        << id_target_ind_xcorr_shape[i] << ", "
-                                        << id_target_ind_log_sn_score[i] << ", "
-                                        << id_target_ind_massdev_score[i] << ", "
-                                        << id_target_ind_mi_score[i] << ", "
-                                        << id_target_ind_mi_ratio_score[i] << ", "
-                                        << id_target_ind_isotope_correlation[i] << ", "
-                                        << id_target_ind_isotope_overlap[i] << "); ";
+            separate_scores.push_back(getSeparateScore(feature_it, prefix + score.second));
           }
-        }
-
-        auto id_decoy_transition_names = getSeparateScore(feature_it, "id_decoy_transition_names");
-        auto id_decoy_area_intensity = getSeparateScore(feature_it, "id_decoy_area_intensity");
-        auto id_decoy_total_area_intensity = getSeparateScore(feature_it, "id_decoy_total_area_intensity");
-        auto id_decoy_apex_intensity = getSeparateScore(feature_it, "id_decoy_apex_intensity");
-        auto id_decoy_total_mi = getSeparateScore(feature_it, "id_decoy_total_mi");
-        auto id_decoy_intensity_score = getSeparateScore(feature_it, "id_decoy_intensity_score");
-        auto id_decoy_intensity_ratio_score = getSeparateScore(feature_it, "id_decoy_intensity_ratio_score");
-        auto id_decoy_log_intensity = getSeparateScore(feature_it, "id_decoy_ind_log_intensity");
-        auto id_decoy_ind_xcorr_coelution = getSeparateScore(feature_it, "id_decoy_ind_xcorr_coelution");
-        auto id_decoy_ind_xcorr_shape = getSeparateScore(feature_it, "id_decoy_ind_xcorr_shape");
-        auto id_decoy_ind_log_sn_score = getSeparateScore(feature_it, "id_decoy_ind_log_sn_score");
-        auto id_decoy_ind_massdev_score = getSeparateScore(feature_it, "id_decoy_ind_massdev_score");
-        auto id_decoy_ind_mi_score = getSeparateScore(feature_it, "id_decoy_ind_mi_score");
-        auto id_decoy_ind_mi_ratio_score = getSeparateScore(feature_it, "id_decoy_ind_mi_ratio_score");
-        auto id_decoy_ind_isotope_correlation = getSeparateScore(feature_it, "id_decoy_ind_isotope_correlation");
-        auto id_decoy_ind_isotope_overlap = getSeparateScore(feature_it, "id_decoy_ind_isotope_overlap");
-
-        if (feature_it.metaValueExists("id_decoy_num_transitions"))
-        {
-          int id_decoy_num_transitions = feature_it.getMetaValue("id_decoy_num_transitions");
 
-          for (int i = 0; i < id_decoy_num_transitions; ++i)
+          int num_transitions = feature_it.getMetaValue(prefix + "num_transitions");
+          for (int i = 0; i < num_transitions; ++i)
           {
-             sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-                "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-                " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-                " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-                " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-                " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE) "\
-                "VALUES ("
-                                        << feature_id << ", "
-                                        << id_decoy_transition_names[i] << ", "
-                                        << id_decoy_area_intensity[i] << ", "
-                                        << id_decoy_total_area_intensity[i] << ", "
-                                        << id_decoy_apex_intensity[i] << ", "
-                                        << id_decoy_total_mi[i] << ", "
-                                        << id_decoy_intensity_score[i] << ", "
-                                        << id_decoy_intensity_ratio_score[i] << ", "
-                                        << id_decoy_log_intensity[i] << ", "
-                                        << id_decoy_ind_xcorr_coelution[i] << ", "
-                                        << id_decoy_ind_xcorr_shape[i] << ", "
-                                        << id_decoy_ind_log_sn_score[i] << ", "
-                                        << id_decoy_ind_massdev_score[i] << ", "
-                                        << id_decoy_ind_mi_score[i] << ", "
-                                        << id_decoy_ind_mi_ratio_score[i] << ", "
-                                        << id_decoy_ind_isotope_correlation[i] << ", "
-                                        << id_decoy_ind_isotope_overlap[i] << "); ";
+            addInt(rows.feature_transition_uis, feature_id);
+            for (const auto& scores : separate_scores)
+            {
+              if (i < (int)scores.size())
+              {
+                addText(rows.feature_transition_uis, texts, scores[i]);
+              }
+              else
+              {
+                addNull(rows.feature_transition_uis);
+              }
+            }
           }
         }
       }
     }
 
-    if (enable_uis_scoring_ && !sql_feature_uis_transition.str().empty() )
+    // with UIS scoring, the transition-level scores replace the plain transition rows
+    if (enable_uis_scoring_ && rows.feature_transition_uis.size() > uis_transitions_start)
     {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_uis_transition.str();
-    }
-    else
-    {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_ms2_transition.str();
+      rows.feature_transition.resize(transitions_start);
     }
+  }
 
+  String OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& /* pep */,
+                                         const OpenSwath::LightTransition* /* transition */,
+                                         const FeatureMap& output,
+                                         const String& id) const
+  {
+    OSWRows rows;
+    prepareRows(output, id, rows);
+
+    std::stringstream sql;
+    appendInsertStatements(sql, "FEATURE", featureColumns(), rows.feature, rows.texts);
+    appendInsertStatements(sql, "FEATURE_MS1", featureMS1Columns(), rows.feature_ms1, rows.texts);
+    appendInsertStatements(sql, "FEATURE_PRECURSOR", featurePrecursorColumns(), rows.feature_precursor, rows.texts);
+    appendInsertStatements(sql, "FEATURE_MS2", featureMS2Columns(), rows.feature_ms2, rows.texts);
+    appendInsertStatements(sql, "FEATURE_TRANSITION", featureTransitionColumns(), rows.feature_transition, rows.texts);
+    appendInsertStatements(sql, "FEATURE_TRANSITION", featureTransitionUISColumns(), rows.feature_transition_uis, rows.texts);
     return sql.str();
   }
 
@@ -484,5 +682,19 @@ namespace OpenMS
     }
     conn.executeStatement("END TRANSACTION");
   }
-}
 
+  void OpenSwathOSWWriter::writeRows(const OSWRows& rows)
+  {
+    if (rows.empty()) return;
+
+    SqliteConnector conn(output_filename_);
+    conn.executeStatement("BEGIN TRANSACTION");
+    insertRows(conn.getDB(), "FEATURE", featureColumns(), rows.feature, rows.texts);
+    insertRows(conn.getDB(), "FEATURE_MS1", featureMS1Columns(), rows.feature_ms1, rows.texts);
+    insertRows(conn.getDB(), "FEATURE_PRECURSOR", featurePrecursorColumns(), rows.feature_precursor, rows.texts);
+    insertRows(conn.getDB(), "FEATURE_MS2", featureMS2Columns(), rows.feature_ms2, rows.texts);
+    insertRows(conn.getDB(), "FEATURE_TRANSITION", featureTransitionColumns(), rows.feature_transition, rows.texts);
+    insertRows(conn.getDB(), "FEATURE_TRANSITION", featureTransitionUISColumns(), rows.feature_transition_uis, rows.texts);
+    conn.executeStatement("END TRANSACTION");
+  }
+}
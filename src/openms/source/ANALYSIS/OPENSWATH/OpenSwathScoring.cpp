@@ -47,6 +47,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SpectrumAddition.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/SummedSpectrumCache.h>
 
 // basic file operations
 
@@ -102,7 +103,8 @@ namespace OpenMS
     spacing_for_spectra_resampling_(0.005),
     add_up_spectra_(1),
     spectra_addition_method_("simple"),
-    im_drift_extra_pcnt_(0.0)
+    im_drift_extra_pcnt_(0.0),
+    spectrum_cache_(nullptr)
   {
   }
 
@@ -126,6 +128,11 @@ namespace OpenMS
     this->su_ = su;
   }
 
+  void OpenSwathScoring::setSpectrumCache(SummedSpectrumCache* cache)
+  {
+    spectrum_cache_ = cache;
+  }
+
   void OpenSwathScoring::calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature,
                                             const std::vector<TransitionType>& transitions,
                                             const std::vector<OpenSwath::SwathMap>& swath_maps,
@@ -626,69 +633,86 @@ namespace OpenMS
       closest_idx--;
     }
 
-    if (nr_spectra_to_add == 1)
+    auto compute = [&]()
     {
-      added_spec = swath_map->getSpectrumById(closest_idx);
-      if (drift_upper > 0) 
-      {
-        added_spec = filterByDrift(added_spec, drift_lower, drift_upper);
-      }
-    }
-    else
-    {
-      std::vector<OpenSwath::SpectrumPtr> all_spectra;
-      // always add the spectrum 0, then add those right and left
-      all_spectra.push_back(swath_map->getSpectrumById(closest_idx));
-      for (int i = 1; i <= nr_spectra_to_add / 2; i++) // cast to int is intended!
+      if (nr_spectra_to_add == 1)
       {
-        if (closest_idx - i >= 0)
+        added_spec = swath_map->getSpectrumById(closest_idx);
+        if (drift_upper > 0) 
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
+          added_spec = filterByDrift(added_spec, drift_lower, drift_upper);
         }
-        if (closest_idx + i < (int)swath_map->getNrSpectra())
-        {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
-        }
-      }
-
-      // Filter all spectra by drift time before further processing
-      if (drift_upper > 0) 
-      {
-        for (auto& s: all_spectra) s = filterByDrift(s, drift_lower, drift_upper);
       }
-
-      // add up all spectra
-      if (spectra_addition_method_ == "simple")
+      else
       {
-        // Ensure that we have the same number of data arrays as in the input spectrum
-        if (!all_spectra.empty() && all_spectra[0]->getDataArrays().size() > 2)
+        std::vector<OpenSwath::SpectrumPtr> all_spectra;
+        // always add the spectrum 0, then add those right and left
+        all_spectra.push_back(swath_map->getSpectrumById(closest_idx));
+        for (int i = 1; i <= nr_spectra_to_add / 2; i++) // cast to int is intended!
         {
-          for (Size k = 2; k < all_spectra[0]->getDataArrays().size(); k++)
+          if (closest_idx - i >= 0)
+          {
+            all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
+          }
+          if (closest_idx + i < (int)swath_map->getNrSpectra())
           {
-            OpenSwath::BinaryDataArrayPtr tmp (new OpenSwath::BinaryDataArray());
-            tmp->description = all_spectra[0]->getDataArrays()[k]->description;
-            added_spec->getDataArrays().push_back(tmp);
+            all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
           }
         }
 
-        // Simply add up data and sort in the end
-        for (const auto& s : all_spectra)
+        // Filter all spectra by drift time before further processing
+        if (drift_upper > 0) 
         {
-          for (Size k = 0; k < s->getDataArrays().size(); k++)
+          for (auto& s: all_spectra) s = filterByDrift(s, drift_lower, drift_upper);
+        }
+
+        // add up all spectra
+        if (spectra_addition_method_ == "simple")
+        {
+          // Ensure that we have the same number of data arrays as in the input spectrum
+          if (!all_spectra.empty() && all_spectra[0]->getDataArrays().size() > 2)
           {
-            auto& v1 = added_spec->getDataArrays()[k]->data;
-            auto& v2 = s->getDataArrays()[k]->data;
+            for (Size k = 2; k < all_spectra[0]->getDataArrays().size(); k++)
+            {
+              OpenSwath::BinaryDataArrayPtr tmp (new OpenSwath::BinaryDataArray());
+              tmp->description = all_spectra[0]->getDataArrays()[k]->description;
+              added_spec->getDataArrays().push_back(tmp);
+            }
+          }
 
-            v1.reserve( v1.size() + v2.size() ); 
-            v1.insert( v1.end(), v2.begin(), v2.end() );
+          // Simply add up data and sort in the end
+          for (const auto& s : all_spectra)
+          {
+            for (Size k = 0; k < s->getDataArrays().size(); k++)
+            {
+              auto& v1 = added_spec->getDataArrays()[k]->data;
+              auto& v2 = s->getDataArrays()[k]->data;
+
+              v1.reserve( v1.size() + v2.size() ); 
+              v1.insert( v1.end(), v2.begin(), v2.end() );
+            }
           }
+          sortSpectrumByMZ(*added_spec);
+        }
+        else
+        {
+          added_spec = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
         }
-        sortSpectrumByMZ(*added_spec);
-      }
-      else
-      {
-        added_spec = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
       }
+      return added_spec;
+    };
+
+    // the same spectra are requested repeatedly for the scores of a peak group
+    // and for other peak groups with their apex at the same scan
+    if (spectrum_cache_ != nullptr)
+    {
+      added_spec = spectrum_cache_->getSpectrum(SummedSpectrumCache::Key(swath_map.get(), closest_idx,
+                                                  nr_spectra_to_add, drift_lower, drift_upper,
+                                                  spectra_addition_method_, spacing_for_spectra_resampling_), compute);
+    }
+    else
+    {
+      added_spec = compute();
     }
 
     OPENMS_POSTCONDITION( std::adjacent_find(added_spec->getMZArray()->data.begin(),
@@ -34,6 +34,13 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -80,6 +87,24 @@ namespace OpenMS
     TransformationDescription trafo; // dummy
     this->simpleExtractChromatograms_(swath_maps, irt_transitions, irt_chromatograms, trafo, cp_irt, sonar, load_into_memory);
 
+    return performRTNormalization(irt_transitions, irt_chromatograms, swath_maps, im_trafo,
+                                  min_rsq, min_coverage, feature_finder_param,
+                                  irt_detection_param, calibration_param, irt_mzml_out, debug_level);
+  }
+
+  TransformationDescription OpenSwathCalibrationWorkflow::performRTNormalization(
+    const OpenSwath::LightTargetedExperiment& irt_transitions,
+    const std::vector< OpenMS::MSChromatogram >& irt_chromatograms,
+    std::vector< OpenSwath::SwathMap > & swath_maps,
+    TransformationDescription& im_trafo,
+    double min_rsq,
+    double min_coverage,
+    const Param& feature_finder_param,
+    const Param& irt_detection_param,
+    const Param& calibration_param,
+    const String& irt_mzml_out,
+    Size debug_level)
+  {
     // debug output of the iRT chromatograms
     if (irt_mzml_out.empty() && debug_level > 1)
       {
@@ -421,6 +446,130 @@ namespace OpenMS
     this->endProgress();
   }
 
+  std::function<void (const OpenMS::MSSpectrum&)> OpenSwathCalibrationWorkflow::getStreamingExtractionFunc(
+    const OpenSwath::LightTargetedExperiment& irt_transitions,
+    const ChromExtractParams& cp)
+  {
+    if (cp.im_extraction_window > 0.0 || cp.extraction_function != "tophat")
+    {
+      throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+
+    streaming_transitions_ = irt_transitions;
+    streaming_cp_ = cp;
+    streaming_windows_.clear();
+    return [this](const OpenMS::MSSpectrum& spectrum) { extractStreamingSpectrum_(spectrum); };
+  }
+
+  void OpenSwathCalibrationWorkflow::extractStreamingSpectrum_(const OpenMS::MSSpectrum& spectrum)
+  {
+    if (spectrum.getMSLevel() == 1 || spectrum.getPrecursors().empty())
+    {
+      return;
+    }
+
+    // assign the spectrum to its SWATH window by the precursor m/z (the
+    // window center), as done by FullSwathFileConsumer
+    const Precursor& prec = spectrum.getPrecursors()[0];
+    const double center = prec.getMZ();
+    StreamingWindow_* window = nullptr;
+    for (auto& w : streaming_windows_)
+    {
+      if (std::fabs(center - w.center) < 1e-6)
+      {
+        window = &w;
+        break;
+      }
+    }
+    if (window == nullptr)
+    {
+      // a new window: select its transitions (as simpleExtractChromatograms_() does for each map)
+      streaming_windows_.emplace_back();
+      window = &streaming_windows_.back();
+      window->center = center;
+      OpenSwathHelper::selectSwathTransitions(streaming_transitions_, window->transitions, streaming_cp_.min_upper_edge_dist,
+          center - prec.getIsolationWindowLowerOffset(), center + prec.getIsolationWindowUpperOffset());
+      if (!window->transitions.getTransitions().empty())
+      {
+        TransformationDescription trafo_inverse; // dummy
+        trafo_inverse.invert();
+        prepareExtractionCoordinates_(window->chrom_list, window->coordinates, window->transitions, trafo_inverse, streaming_cp_);
+      }
+    }
+
+    if (window->coordinates.empty() || spectrum.empty())
+    {
+      return;
+    }
+
+    // same per-spectrum extraction as ChromatogramExtractorAlgorithm::extractChromatograms()
+    OpenSwath::SpectrumPtr sptr = OpenSwathDataAccessHelper::convertToSpectrumPtr(spectrum);
+    const std::vector<double>& mz_arr = sptr->getMZArray()->data;
+    const std::vector<double>& int_arr = sptr->getIntensityArray()->data;
+    std::vector<double>::const_iterator mz_it = mz_arr.begin();
+    std::vector<double>::const_iterator int_it = int_arr.begin();
+    const double current_rt = spectrum.getRT();
+
+    ChromatogramExtractorAlgorithm extractor;
+    for (Size k = 0; k < window->coordinates.size(); ++k)
+    {
+      const ChromatogramExtractorAlgorithm::ExtractionCoordinates& coord = window->coordinates[k];
+      if (coord.rt_end - coord.rt_start > 0 && (current_rt < coord.rt_start || current_rt > coord.rt_end))
+      {
+        continue;
+      }
+
+      double integrated_intensity = 0;
+      extractor.extract_value_tophat(mz_arr.begin(), mz_it, mz_arr.end(), int_it,
+                                     coord.mz, integrated_intensity, streaming_cp_.mz_extraction_window, streaming_cp_.ppm);
+      window->chrom_list[k]->getTimeArray()->data.push_back(current_rt);
+      window->chrom_list[k]->getIntensityArray()->data.push_back(integrated_intensity);
+    }
+  }
+
+  void OpenSwathCalibrationWorkflow::retrieveStreamingChromatograms(std::vector< OpenMS::MSChromatogram >& chromatograms)
+  {
+    // report windows in m/z order, independent of the acquisition order
+    std::sort(streaming_windows_.begin(), streaming_windows_.end(),
+      [](const StreamingWindow_& a, const StreamingWindow_& b) { return a.center < b.center; });
+
+    int nr_empty_chromatograms = 0;
+    for (StreamingWindow_& w : streaming_windows_)
+    {
+      if (w.coordinates.empty())
+      {
+        continue;
+      }
+
+      std::vector< OpenMS::MSChromatogram > tmp_chromatograms;
+      ChromatogramExtractor::return_chromatogram(w.chrom_list, w.coordinates, w.transitions,
+          SpectrumSettings(), tmp_chromatograms, false, streaming_cp_.im_extraction_window);
+      for (Size chrom_idx = 0; chrom_idx < tmp_chromatograms.size(); chrom_idx++)
+      {
+        // remove empty chromatograms (see simpleExtractChromatograms_())
+        double tic = std::accumulate(w.chrom_list[chrom_idx]->getIntensityArray()->data.begin(),
+                                     w.chrom_list[chrom_idx]->getIntensityArray()->data.end(), 0.0);
+        if (tic > 0.0)
+        {
+          chromatograms.push_back(tmp_chromatograms[chrom_idx]);
+        }
+        else
+        {
+          OPENMS_LOG_DEBUG << " - Warning: Empty chromatogram " << w.coordinates[chrom_idx].id <<
+            " detected. Will skip it!" << std::endl;
+          nr_empty_chromatograms++;
+        }
+      }
+    }
+    if (nr_empty_chromatograms > 0)
+    {
+      std::cerr << " - Warning: Detected " << nr_empty_chromatograms << " empty chromatograms. Will skip them!" << std::endl;
+    }
+
+    streaming_windows_.clear();
+    streaming_transitions_ = OpenSwath::LightTargetedExperiment();
+  }
+
   void OpenSwathCalibrationWorkflow::addChromatograms(MSChromatogram& base_chrom, const MSChromatogram& newchrom)
   {
     if (base_chrom.empty())
@@ -538,206 +687,274 @@ namespace OpenMS
     }
 
     // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
-    // We set dynamic scheduling such that the maps are worked on in the order
-    // in which they were given to the program / acquired. This gives much
-    // better load balancing than static allocation.
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
-    if (threads_outer_loop_ > -1)
-    {
-      std::cout << "Setting up nested loop with " << std::min(threads_outer_loop_, omp_get_max_threads()) << " threads out of "<< omp_get_max_threads() << std::endl;
-      omp_set_nested(1);
-      omp_set_dynamic(0);
-      omp_set_num_threads(std::min(threads_outer_loop_, omp_get_max_threads()) ); // use at most threads_outer_loop_ threads here
-    }
-    else
+    //
+    // Step 1: select which transitions to extract from each SWATH window and
+    // split them into batches. Each (window, batch) pair is an independent
+    // task and all tasks are handed out over all threads, so that threads
+    // never idle while large windows are still being processed.
+    //
+    // The selection of each window is computed only once and kept as indices
+    // into transition_exp: holding copies of the selected transitions of all
+    // windows at once would duplicate most of the library. A window's copy is
+    // created from these indices by its first task and released after its
+    // last one.
+    struct WindowSelection
     {
-      std::cout << "Use non-nested loop with " << total_nr_threads << " threads." << std::endl;
-    }
-#endif
+      std::vector<Size> transitions;
+      std::vector<Size> compounds;
+      std::vector<Size> proteins;
+    };
+    std::vector<WindowSelection> window_selection(swath_maps.size());
 #pragma omp parallel for schedule(dynamic,1)
-#endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
     {
-      if (!swath_maps[i].ms1) // skip MS1
-      {
+      if (swath_maps[i].ms1) continue; // skip MS1
 
-        // Step 1: select which transitions to extract (proceed in batches)
-        OpenSwath::LightTargetedExperiment transition_exp_used_all;
+      WindowSelection& selection = window_selection[i];
+      std::set<std::string> matching_compounds;
+      for (Size k = 0; k < transition_exp.transitions.size(); k++)
+      {
+        const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
+        bool selected;
         if (!prm_)
         {
-          // Step 1.1: select transitions matching the window
-          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-              cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
+          // Step 1.1: select transitions matching the window (see OpenSwathHelper::selectSwathTransitions)
+          selected = swath_maps[i].lower < tr.getPrecursorMZ() && tr.getPrecursorMZ() < swath_maps[i].upper &&
+                     std::fabs(swath_maps[i].upper - tr.getPrecursorMZ()) >= cp.min_upper_edge_dist;
         }
         else
         {
           // Step 1.2: select transitions based on matching PRM window (best window)
-          std::set<std::string> matching_compounds;
-          for (Size k = 0; k < prm_map.size(); k++)
-          {
-            if (prm_map[k] == i)
-            {
-               const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
-               transition_exp_used_all.transitions.push_back(tr);
-               matching_compounds.insert(tr.getPeptideRef());
-            }
-          }
-
-          std::set<std::string> matching_proteins;
-          for (Size i = 0; i < transition_exp.compounds.size(); i++)
-          {
-            if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
-            {
-              transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
-              for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
-              {
-                matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
-              }
-            }
-          }
-          for (Size i = 0; i < transition_exp.proteins.size(); i++)
-          {
-            if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
-            {
-              transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
-            }
-          }
+          selected = (prm_map[k] == i);
         }
-
-        if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
+        if (selected)
         {
+          selection.transitions.push_back(k);
+          matching_compounds.insert(tr.getPeptideRef());
+        }
+      }
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
+      std::set<std::string> matching_proteins;
+      for (Size k = 0; k < transition_exp.compounds.size(); k++)
+      {
+        if (matching_compounds.find(transition_exp.compounds[k].id) != matching_compounds.end())
+        {
+          selection.compounds.push_back(k);
+          for (Size j = 0; j < transition_exp.compounds[k].protein_refs.size(); j++)
           {
-            // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
+            matching_proteins.insert(transition_exp.compounds[k].protein_refs[j]);
           }
+        }
+      }
+      for (Size k = 0; k < transition_exp.proteins.size(); k++)
+      {
+        if (matching_proteins.find(transition_exp.proteins[k].id) != matching_proteins.end())
+        {
+          selection.proteins.push_back(k);
+        }
+      }
+    }
 
-          int batch_size;
-          if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
-          {
-            batch_size = transition_exp_used_all.getCompounds().size();
-          }
-          else
-          {
-            batch_size = batchSize;
-          }
+    // Tasks are ordered by window (in the order in which they were given to
+    // the program / acquired) so that only a few windows are worked on at
+    // any time.
+    std::vector< std::pair<Size, SignedSize> > tasks; // (window, batch)
+    std::vector<int> window_batch_size(swath_maps.size(), 0);
+    std::vector<SignedSize> window_nr_batches(swath_maps.size(), 0);
+    std::vector<Size> window_open_tasks(swath_maps.size(), 0);
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      if (window_selection[i].transitions.empty())
+      {
+        // skip if no transitions found (or MS1)
+        this->setProgress(++progress);
+        continue;
+      }
 
-          SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
+      const int nr_compounds = (int)window_selection[i].compounds.size();
+      window_batch_size[i] = (batchSize <= 0 || batchSize >= nr_compounds) ? nr_compounds : batchSize;
+      window_nr_batches[i] = nr_compounds / window_batch_size[i];
+      for (SignedSize pep_idx = 0; pep_idx <= window_nr_batches[i]; pep_idx++)
+      {
+        tasks.emplace_back(i, pep_idx);
+      }
+      window_open_tasks[i] = window_nr_batches[i] + 1;
+    }
 
+    // Memory-aware throttling: when loading the data into memory, at most
+    // max_resident_windows SWATH windows are held in memory at once. The
+    // in-memory copy of a window is created by the first of its tasks and
+    // released after its last task has finished. A task that would exceed the
+    // limit waits until another window has been released. This cannot
+    // deadlock because tasks are taken from a shared counter strictly in
+    // window order: all tasks of an earlier window have been started before
+    // a later window waits for it. (A dynamic OpenMP schedule does not
+    // guarantee this order, since it may be implemented by work stealing.)
+    int max_resident_windows = threads_outer_loop_;
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-          // If we have a multiple of threads_outer_loop_ here, then use nested
-          // parallelization here. E.g. if we use 8 threads for the outer loop,
-          // but we have a total of 24 cores available, each of the 8 threads
-          // will then create a team of 3 threads to work on the batches
-          // individually.
-          //
-          // We should avoid oversubscribing the CPUs, therefore we use integer division.
-          // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
-          int outer_thread_nr = omp_get_thread_num();
-          omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
-#pragma omp parallel for schedule(dynamic, 1)
-#endif
+    if (max_resident_windows <= 0) max_resident_windows = omp_get_max_threads();
+#else
+    if (max_resident_windows <= 0) max_resident_windows = 1;
 #endif
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
+    enum WindowState {NOT_LOADED, LOADING, LOADED};
+    std::vector<WindowState> window_state(swath_maps.size(), NOT_LOADED);
+    std::vector<OpenSwath::SpectrumAccessPtr> resident_maps(swath_maps.size());
+    int nr_resident_windows = 0;
+    std::vector<WindowState> transitions_state(swath_maps.size(), NOT_LOADED);
+    std::vector< std::shared_ptr<const OpenSwath::LightTargetedExperiment> > window_transitions(swath_maps.size());
+    std::mutex resident_mutex;
+    std::condition_variable resident_cv;
+
+    std::atomic<Size> next_task(0);
+#pragma omp parallel
+    for (Size task_idx = next_task++; task_idx < tasks.size(); task_idx = next_task++)
+    {
+      const Size i = tasks[task_idx].first;
+      const SignedSize pep_idx = tasks[task_idx].second;
+
+      // Obtain the transitions of the current window (selected by its first task)
+      std::shared_ptr<const OpenSwath::LightTargetedExperiment> window_transitions_ptr;
+      {
+        std::unique_lock<std::mutex> lock(resident_mutex);
+        resident_cv.wait(lock, [&] { return transitions_state[i] != LOADING; });
+        if (transitions_state[i] == NOT_LOADED)
+        {
+          transitions_state[i] = LOADING;
+          lock.unlock();
+          std::shared_ptr<OpenSwath::LightTargetedExperiment> selected(new OpenSwath::LightTargetedExperiment);
+          const WindowSelection& selection = window_selection[i];
+          selected->transitions.reserve(selection.transitions.size());
+          for (Size k : selection.transitions) selected->transitions.push_back(transition_exp.transitions[k]);
+          selected->compounds.reserve(selection.compounds.size());
+          for (Size k : selection.compounds) selected->compounds.push_back(transition_exp.compounds[k]);
+          selected->proteins.reserve(selection.proteins.size());
+          for (Size k : selection.proteins) selected->proteins.push_back(transition_exp.proteins[k]);
+          lock.lock();
+          window_transitions[i] = selected;
+          transitions_state[i] = LOADED;
+          resident_cv.notify_all();
+        }
+        window_transitions_ptr = window_transitions[i];
+      }
+      const OpenSwath::LightTargetedExperiment& transition_exp_used_all = *window_transitions_ptr;
+
+      // Obtain the data of the current window
+      OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
+      if (load_into_memory)
+      {
+        std::unique_lock<std::mutex> lock(resident_mutex);
+        resident_cv.wait(lock, [&]
           {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+            return window_state[i] == LOADED ||
+                   (window_state[i] == NOT_LOADED && nr_resident_windows < max_resident_windows);
+          });
+        if (window_state[i] == NOT_LOADED)
+        {
+          window_state[i] = LOADING;
+          ++nr_resident_windows;
+          lock.unlock();
+          // This creates an InMemory object that keeps all data in memory
+          OpenSwath::SpectrumAccessPtr in_memory = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
+          lock.lock();
+          resident_maps[i] = in_memory;
+          window_state[i] = LOADED;
+          resident_cv.notify_all();
+        }
+        current_swath_map = resident_maps[i];
+      }
+
+      // To ensure multi-threading safe access to the individual spectra, we
+      // need to use a light clone of the spectrum access (if multiple threads
+      // share a single filestream and call seek on it, chaos will ensue).
+      OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map->lightClone();
 
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
-            {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
-#endif
 #pragma omp critical (osw_write_stdout)
 #endif
-            {
-              std::cout << "Thread " <<
+      {
+        std::cout << "Thread " <<
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
-#else
-              omp_get_thread_num() << "_0 " <<
-#endif
+        omp_get_thread_num() << " " <<
 #else
-              "0" << 
+        "0 " <<
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
-
-            // Extract MS1 chromatograms for this batch
-            std::vector< MSChromatogram > ms1_chromatograms;
-            if (ms1_map_ != nullptr) 
-            {
-              OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
-              MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
-                  transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
-            }
+        "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+        << transition_exp_used_all.getTransitions().size() <<  " transitions "
+        "from SWATH " << i << " (batch " << pep_idx << " out of " << window_nr_batches[i] << ")" << std::endl;
+      }
 
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+      // Create the new, batch-size transition experiment
+      OpenSwath::LightTargetedExperiment transition_exp_used;
+      selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, window_batch_size[i], pep_idx);
 
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
+      // Extract MS1 chromatograms for this batch
+      std::vector< MSChromatogram > ms1_chromatograms;
+      if (ms1_map_ != nullptr) 
+      {
+        OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
+        MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
+            transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
+      }
 
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+      // Step 2.1: extract these transitions
+      ChromatogramExtractor extractor;
+      std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+      std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
 
+      // Step 2.2: prepare the extraction coordinates and extract chromatograms
+      // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
+      prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
+      extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
+          cp.ppm, cp.im_extraction_window, cp.extraction_function);
 
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+      // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
+      PeakMap chrom_exp;
+      extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
+                                    chrom_exp.getChromatograms(), false, cp.im_extraction_window);
 
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
-            }
-          }
 
-        } // continue 2 (no continue due to OpenMP)
-      } // continue 1 (no continue due to OpenMP)
+      // Step 3: score these extracted transitions
+      FeatureMap featureFile;
+      std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
+      tmp.back().sptr = current_swath_map_inner;
+      scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+          feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+
+      // Step 4: write all chromatograms and features out into an output object / file
+      // (this needs to be done in a critical section since we only have one
+      // output file and one output map).
+      #pragma omp critical (osw_write_out)
+      {
+        writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+      }
 
-      #pragma omp critical (progress)
-      this->setProgress(++progress);
+      // Release the data of the window after its last batch
+      current_swath_map_inner.reset();
+      current_swath_map.reset();
+      bool window_done = false;
+      {
+        std::lock_guard<std::mutex> lock(resident_mutex);
+        window_done = (--window_open_tasks[i] == 0);
+        if (window_done)
+        {
+          window_transitions[i].reset();
+          window_selection[i] = WindowSelection();
+        }
+        if (window_done && load_into_memory)
+        {
+          resident_maps[i].reset();
+          --nr_resident_windows;
+          resident_cv.notify_all();
+        }
+      }
 
+      if (window_done)
+      {
+        #pragma omp critical (progress)
+        this->setProgress(++progress);
+      }
     }
     this->endProgress();
-    
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    if (threads_outer_loop_ > -1)
-    {
-      omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
-    }
-#endif    
-#endif    
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -889,7 +1106,8 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String> to_tsv_output;
+    OpenSwathOSWWriter::OSWRows osw_rows;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
@@ -978,11 +1196,7 @@ namespace OpenMS
       // 6. Add to the output osw if given
       if (osw_writer.isActive() && output.size() > 0) // implies that detection_assay_it was set
       {
-        const OpenSwath::LightCompound pep;
-        to_osw_output.push_back(osw_writer.prepareLine(OpenSwath::LightCompound(), // not used currently: transition_exp.getCompounds()[ assay_peptide_map[id] ],
-                                                       nullptr, // not used currently: detection_assay_it,
-                                                       output,
-                                                       id));
+        osw_writer.prepareRows(output, id, osw_rows);
       }
     }
 
@@ -1004,7 +1218,7 @@ namespace OpenMS
 #pragma omp critical (osw_write_tsv)
 #endif
       {
-        osw_writer.writeLines(to_osw_output);
+        osw_writer.writeRows(osw_rows);
       }
     }
   }
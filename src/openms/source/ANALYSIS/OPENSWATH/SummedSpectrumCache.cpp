@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/SummedSpectrumCache.h>
+
+namespace OpenMS
+{
+  SummedSpectrumCache::SummedSpectrumCache(Size capacity) :
+    capacity_(capacity),
+    hits_(0),
+    misses_(0)
+  {
+  }
+
+  SummedSpectrumCache::~SummedSpectrumCache()
+  {
+  }
+
+  OpenSwath::SpectrumPtr SummedSpectrumCache::getSpectrum(const Key& key, const std::function<OpenSwath::SpectrumPtr()>& compute)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto pos = index_.find(key);
+      if (pos != index_.end())
+      {
+        ++hits_;
+        // mark as most recently used
+        entries_.splice(entries_.begin(), entries_, pos->second);
+        return pos->second->second;
+      }
+      ++misses_;
+    }
+
+    // compute without holding the lock, so other threads can use the cache meanwhile
+    OpenSwath::SpectrumPtr spectrum = compute();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pos = index_.find(key);
+    if (pos != index_.end())
+    { // another thread was faster - use its spectrum
+      entries_.splice(entries_.begin(), entries_, pos->second);
+      return pos->second->second;
+    }
+    if (capacity_ == 0)
+    {
+      return spectrum;
+    }
+    entries_.emplace_front(key, spectrum);
+    index_[key] = entries_.begin();
+    shrink_();
+    return spectrum;
+  }
+
+  void SummedSpectrumCache::setCapacity(Size capacity)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    shrink_();
+  }
+
+  Size SummedSpectrumCache::getCapacity() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  Size SummedSpectrumCache::size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  void SummedSpectrumCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
+  Size SummedSpectrumCache::getHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  Size SummedSpectrumCache::getMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  void SummedSpectrumCache::shrink_()
+  {
+    while (entries_.size() > capacity_)
+    {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+}
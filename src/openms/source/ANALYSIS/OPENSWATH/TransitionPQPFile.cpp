@@ -38,6 +38,7 @@
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
 #include <sstream>
+#include <limits>
 
 namespace OpenMS
 {
@@ -64,7 +65,8 @@ namespace OpenMS
     return 0;
   }
 
-  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id,
+                                        double precursor_mz_lower, double precursor_mz_upper)
   {
     sqlite3 *db;
     sqlite3_stmt * cntstmt;
@@ -84,8 +86,29 @@ namespace OpenMS
     SqliteConnector conn(filename);
     db = conn.getDB();
 
+    // Restrict to precursors within [lower, upper) if a range was given; the
+    // bounds are bound as parameters ?1 and ?2 so they are compared exactly
+    bool restrict_mz = precursor_mz_lower > -std::numeric_limits<double>::max() ||
+                       precursor_mz_upper < std::numeric_limits<double>::max();
+    String where_mz = "";
+    if (restrict_mz)
+    {
+      where_mz = "WHERE PRECURSOR.PRECURSOR_MZ >= ?1 AND PRECURSOR.PRECURSOR_MZ < ?2 ";
+    }
+
     // Count transitions
-    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    if (restrict_mz)
+    {
+      SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION " \
+        "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON TRANSITION.ID = TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID " \
+        "INNER JOIN PRECURSOR ON TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID = PRECURSOR.ID " + where_mz + ";");
+      sqlite3_bind_double(cntstmt, 1, precursor_mz_lower);
+      sqlite3_bind_double(cntstmt, 2, precursor_mz_upper);
+    }
+    else
+    {
+      SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    }
     sqlite3_step( cntstmt );
     int num_transitions = sqlite3_column_int(cntstmt, 0);
     sqlite3_finalize(cntstmt);
@@ -167,7 +190,8 @@ namespace OpenMS
                     "FROM TRANSITION_PEPTIDE_MAPPING "\
                     "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
                     "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID " +
+                  where_mz;
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -206,15 +230,22 @@ namespace OpenMS
                   "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
-                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
+                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID " +
+                  where_mz + "; ";
 
 
     // Execute SQL select statement
     SqliteConnector::prepareStatement(db, &stmt, select_sql);
+    if (restrict_mz)
+    {
+      sqlite3_bind_double(stmt, 1, precursor_mz_lower);
+      sqlite3_bind_double(stmt, 2, precursor_mz_upper);
+    }
     sqlite3_step(stmt);
     endProgress();
 
     Size progress = 0;
+    transition_list.reserve(transition_list.size() + num_transitions);
     startProgress(0, num_transitions, "reading PQP file");
     // Convert SQLite data to TSVTransition data structure
     while (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
@@ -258,7 +289,7 @@ namespace OpenMS
 
       if (mytransition.GeneName == "NA") mytransition.GeneName = "";
 
-      transition_list.push_back(mytransition);
+      transition_list.push_back(std::move(mytransition));
       sqlite3_step( stmt );
     }
     endProgress();
@@ -708,5 +739,16 @@ namespace OpenMS
     TSVToTargetedExperiment_(transition_list, targeted_exp);
   }
 
+  void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename,
+                                                         OpenSwath::LightTargetedExperiment& targeted_exp,
+                                                         double precursor_mz_lower,
+                                                         double precursor_mz_upper,
+                                                         bool legacy_traml_id)
+  {
+    std::vector<TSVTransition> transition_list;
+    readPQPInput_(filename, transition_list, legacy_traml_id, precursor_mz_lower, precursor_mz_upper);
+    TSVToTargetedExperiment_(transition_list, targeted_exp);
+  }
+
 }
 
@@ -40,6 +40,8 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/TextFile.h>
 
+#include <unordered_set>
+
 namespace OpenMS
 {
 
@@ -674,17 +676,19 @@ namespace OpenMS
 
   void TransitionTSVFile::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
+    std::unordered_set<std::string> compound_map;
+    std::unordered_set<std::string> protein_map;
 
     resolveMixedSequenceGroups_(transition_list);
 
+    exp.transitions.reserve(exp.transitions.size() + transition_list.size());
+
     Size progress = 0;
     startProgress(0, transition_list.size(), "conversion to internal data representation");
-    for (auto tr_it = transition_list.cbegin(); tr_it != transition_list.cend(); ++tr_it)
+    for (auto tr_it = transition_list.begin(); tr_it != transition_list.end(); ++tr_it)
     {
       OpenSwath::LightTransition transition;
-      transition.transition_name  = tr_it->transition_name;
+      transition.transition_name  = std::move(tr_it->transition_name);
       transition.peptide_ref  = tr_it->group_id;
       transition.library_intensity  = tr_it->library_intensity;
       transition.precursor_mz  = tr_it->precursor;
@@ -700,7 +704,7 @@ namespace OpenMS
       transition.identifying_transition = tr_it->identifying_transition;
       transition.quantifying_transition = tr_it->quantifying_transition;
 
-      exp.transitions.push_back(transition);
+      exp.transitions.push_back(std::move(transition));
 
       // check whether we need a new compound
       if (compound_map.find(tr_it->group_id) == compound_map.end())
@@ -718,8 +722,8 @@ namespace OpenMS
           createCompound_(tr_it, tramlcompound);
           OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
         }
-        exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
+        compound_map.insert(compound.id);
+        exp.compounds.push_back(std::move(compound));
       }
 
       // check whether we need new proteins
@@ -731,10 +735,14 @@ namespace OpenMS
           protein.id = tr_it->ProteinName[i];
           protein.sequence = "";
           exp.proteins.push_back(protein);
-          protein_map[tr_it->ProteinName[i]] = 0;
+          protein_map.insert(tr_it->ProteinName[i]);
         }
       }
 
+      // release the row's strings right away so that the peak memory is not
+      // the sum of the input list and the converted library
+      *tr_it = TSVTransition();
+
       setProgress(progress++);
     }
     endProgress();
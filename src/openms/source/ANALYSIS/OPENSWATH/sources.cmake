@@ -35,6 +35,7 @@ set(sources_list
   SwathWindowLoader.cpp
   SwathQC.cpp
   SpectrumAddition.cpp
+  SummedSpectrumCache.cpp
   TargetedSpectraExtractor.cpp
   TransitionTSVFile.cpp
   TransitionPQPFile.cpp
@@ -192,47 +192,80 @@ namespace OpenMS
       // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
       max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
       last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
+      // the combined mass of both peptides has to fall into this window
+      const double min_pair_mass = precursor_mass - cross_link_mass - allowed_error;
+      const double max_pair_mass = precursor_mass - cross_link_mass + allowed_error;
+
+      // since beta is never lighter than alpha (beta_index >= alpha_index), alpha can be at most half of the pair mass
+      const SignedSize last_alpha_index = upper_bound(peptides.cbegin(), last_alpha, max_pair_mass / 2.0, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+
+      // each thread enumerates a contiguous block of alphas and collects its own pairs,
+      // the blocks are concatenated in thread order afterwards to keep the output deterministic
+      vector< vector< OPXLDataStructs::XLPrecursor > > thread_candidates(1);
+#pragma omp parallel
       {
-        // Constrain search for beta
-        double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
-        double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
+        SignedSize thread_num = 0;
+        SignedSize num_threads = 1;
+#ifdef _OPENMP
+        thread_num = omp_get_thread_num();
+        num_threads = omp_get_num_threads();
+#pragma omp single
+        thread_candidates.resize(num_threads);
+#endif
+        SignedSize block_size = (last_alpha_index + num_threads - 1) / num_threads;
+        SignedSize block_begin = std::min(thread_num * block_size, last_alpha_index);
+        SignedSize block_end = std::min(block_begin + block_size, last_alpha_index);
 
-        // the last_alpha upper bound is also a conservative upper bound here
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
+        vector< OPXLDataStructs::XLPrecursor >& local_candidates = thread_candidates[thread_num];
 
-        if (first_beta == last_beta)
+        if (block_begin < block_end)
         {
-          continue;
-        }
+          // Two-pointer sweep: with increasing alpha mass the window of matching beta masses
+          // moves towards lighter peptides, so both bounds only have to be moved down.
+          // Only the first window of each block needs a binary search.
+          SignedSize first_beta = lower_bound(peptides.cbegin(), last_alpha, min_pair_mass - peptides[block_begin].peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+          SignedSize last_beta = upper_bound(peptides.cbegin(), last_alpha, max_pair_mass - peptides[block_begin].peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
 
-        Size first_beta_index = first_beta - peptides.begin();
-        Size last_beta_index = last_beta - peptides.begin();
+          for (SignedSize p1 = block_begin; p1 < block_end; ++p1)
+          {
+            const double alpha_mass = peptides[p1].peptide_mass;
+            while (first_beta > 0 && peptides[first_beta - 1].peptide_mass >= min_pair_mass - alpha_mass)
+            {
+              --first_beta;
+            }
+            while (last_beta > 0 && peptides[last_beta - 1].peptide_mass > max_pair_mass - alpha_mass)
+            {
+              --last_beta;
+            }
 
-        for (Size p2 = first_beta_index; p2 < last_beta_index; ++p2)
-        {
-          // Monoisotopic weight of the first peptide + the second peptide + cross-linker
-          double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+            // no heavier alpha can have a beta with beta_index >= alpha_index anymore
+            if (last_beta <= p1)
+            {
+              break;
+            }
 
-          // this time both peptides have valid indices
-          OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_pair_mass;
-          precursor.alpha_index = p1;
-          precursor.beta_index = p2;
-          precursor.alpha_seq = peptides[p1].unmodified_seq;
-          precursor.beta_seq = peptides[p2].unmodified_seq;
+            for (SignedSize p2 = std::max(first_beta, p1); p2 < last_beta; ++p2)
+            {
+              // this time both peptides have valid indices
+              OPXLDataStructs::XLPrecursor precursor;
+              // Monoisotopic weight of the first peptide + the second peptide + cross-linker
+              precursor.precursor_mass = alpha_mass + peptides[p2].peptide_mass + cross_link_mass;
+              precursor.alpha_index = p1;
+              precursor.beta_index = p2;
+              precursor.alpha_seq = peptides[p1].unmodified_seq;
+              precursor.beta_seq = peptides[p2].unmodified_seq;
+              local_candidates.push_back(precursor);
+            }
+          } // end of loop over alphas
+        }
+      } // end of parallel region
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over betas
-      } // end of parallel loop over alphas
+      for (const vector< OPXLDataStructs::XLPrecursor >& local_candidates : thread_candidates)
+      {
+        mass_to_candidates.insert(mass_to_candidates.end(), local_candidates.begin(), local_candidates.end());
+        precursor_correction_positions.insert(precursor_correction_positions.end(), local_candidates.size(), pm);
+      }
     } // end of loop over precursor masses
     return mass_to_candidates;
   }
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumCache.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+namespace OpenMS
+{
+  TheoreticalSpectrumCache::TheoreticalSpectrumCache(const TheoreticalSpectrumGenerator& generator, Size capacity) :
+    generator_(generator),
+    capacity_(capacity),
+    hits_(0),
+    misses_(0)
+  {
+  }
+
+  TheoreticalSpectrumCache::~TheoreticalSpectrumCache()
+  {
+  }
+
+  TheoreticalSpectrumCache::SpectrumPtr TheoreticalSpectrumCache::getSpectrum(const AASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge)
+  {
+    String key = peptide.toString() + "/" + String(min_charge) + "/" + String(max_charge) + "/" + String(precursor_charge);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto pos = index_.find(key);
+      if (pos != index_.end())
+      {
+        ++hits_;
+        // mark as most recently used
+        entries_.splice(entries_.begin(), entries_, pos->second);
+        return pos->second->second;
+      }
+      ++misses_;
+    }
+
+    // generate without holding the lock, so other threads can use the cache meanwhile
+    std::shared_ptr<PeakSpectrum> spectrum(new PeakSpectrum());
+    generator_.getSpectrum(*spectrum, peptide, min_charge, max_charge, precursor_charge);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pos = index_.find(key);
+    if (pos != index_.end())
+    { // another thread was faster - use its spectrum
+      entries_.splice(entries_.begin(), entries_, pos->second);
+      return pos->second->second;
+    }
+    if (capacity_ == 0)
+    {
+      return spectrum;
+    }
+    entries_.emplace_front(key, spectrum);
+    index_[key] = entries_.begin();
+    shrink_();
+    return spectrum;
+  }
+
+  void TheoreticalSpectrumCache::setGenerator(const TheoreticalSpectrumGenerator& generator)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generator_ = generator;
+    entries_.clear();
+    index_.clear();
+  }
+
+  TheoreticalSpectrumGenerator TheoreticalSpectrumCache::getGenerator() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generator_;
+  }
+
+  void TheoreticalSpectrumCache::setCapacity(Size capacity)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    shrink_();
+  }
+
+  Size TheoreticalSpectrumCache::getCapacity() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  Size TheoreticalSpectrumCache::size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  void TheoreticalSpectrumCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
+  Size TheoreticalSpectrumCache::getHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  Size TheoreticalSpectrumCache::getMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  void TheoreticalSpectrumCache::shrink_()
+  {
+    while (entries_.size() > capacity_)
+    {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+}
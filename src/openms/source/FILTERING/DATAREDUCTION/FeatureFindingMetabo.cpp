@@ -38,6 +38,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
 #include <fstream>
+#include <unordered_set>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -762,14 +763,7 @@ namespace OpenMS
     FeatureHypothesis tmp_hypo;
     tmp_hypo.addMassTrace(*candidates[0]);
     tmp_hypo.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
-
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-    {
-      // pushing back to shared vector needs to be synchronized
-      output_hypotheses.push_back(tmp_hypo);
-    }
+    output_hypotheses.push_back(tmp_hypo);
 
     for (Size charge = charge_lower_bound_; charge <= charge_upper_bound_; ++charge)
     {
@@ -786,7 +780,7 @@ namespace OpenMS
       for (Size iso_pos = 1; iso_pos <= iso_pos_max; ++iso_pos)
       {
         //estimate expected m/z window for iso_pos
-        Range isotope_window = getTheoreticIsotopicMassWindow_(elements_, iso_pos);
+        const Range& isotope_window = isotope_windows_[iso_pos];
         // Find mass trace that best agrees with current hypothesis of charge
         // and isotopic position
         double best_so_far(0.0);
@@ -845,14 +839,7 @@ namespace OpenMS
           fh_tmp.setScore(fh_tmp.getScore() + weighted_score);
           fh_tmp.setCharge(charge);
           last_iso_idx = best_idx;
-
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-          {
-            // pushing back to shared vector needs to be synchronized
-            output_hypotheses.push_back(fh_tmp);
-          }
+          output_hypotheses.push_back(fh_tmp);
         }
         else
         {
@@ -910,15 +897,25 @@ namespace OpenMS
       total_intensity += input_mtraces[i].getIntensity(use_smoothed_intensities_);
     }
 
+    // the isotopic mass windows only depend on the isotopic position
+    const Size iso_pos_max(static_cast<Size>(std::floor(charge_upper_bound_ * local_mz_range_)));
+    isotope_windows_.assign(iso_pos_max + 1, Range());
+    for (Size iso_pos = 1; iso_pos <= iso_pos_max; ++iso_pos)
+    {
+      isotope_windows_[iso_pos] = getTheoreticIsotopicMassWindow_(elements_, iso_pos);
+    }
+
     // *********************************************************** //
     // Step 2 Iterate through all mass traces to find likely matches 
     // and generate isotopic / charge hypotheses
     // *********************************************************** //
 
-    std::vector<FeatureHypothesis> feat_hypos;
+    // hypotheses are collected per mass trace and concatenated in trace
+    // order, so the result does not depend on the number of threads
+    std::vector<std::vector<FeatureHypothesis> > hypos_per_trace(input_mtraces.size());
     Size progress(0);
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
 #endif
     for (SignedSize i = 0; i < (SignedSize)input_mtraces.size(); ++i)
     {
@@ -947,10 +944,23 @@ namespace OpenMS
           local_traces.push_back(&input_mtraces[ext_idx]);
         }
       }
-      findLocalFeatures_(local_traces, total_intensity, feat_hypos);
+      findLocalFeatures_(local_traces, total_intensity, hypos_per_trace[i]);
     }
     this->endProgress();
 
+    std::vector<FeatureHypothesis> feat_hypos;
+    Size nr_hypos(0);
+    for (const auto& hypos : hypos_per_trace)
+    {
+      nr_hypos += hypos.size();
+    }
+    feat_hypos.reserve(nr_hypos);
+    for (auto& hypos : hypos_per_trace)
+    {
+      feat_hypos.insert(feat_hypos.end(), hypos.begin(), hypos.end());
+      std::vector<FeatureHypothesis>().swap(hypos);
+    }
+
     // sort feature candidates by their score
     std::sort(feat_hypos.begin(), feat_hypos.end(), CmpHypothesesByScore());
 
@@ -970,7 +980,9 @@ namespace OpenMS
     // scoring one. Accept them if they do not contain traces that have 
     // already been used by a higher scoring hypothesis.
     // *********************************************************** //
-    std::map<String, bool> trace_excl_map;
+    std::unordered_set<String> trace_excl_map;
+    trace_excl_map.reserve(input_mtraces.size());
+    std::vector<std::pair<Size, int> > accepted_hypos; // (hypothesis index, result of isotope filter)
     for (Size hypo_idx = 0; hypo_idx < feat_hypos.size(); ++hypo_idx)
     {
       // std::cout << "score now: " <<  feat_hypos[hypo_idx].getScore() << std::endl;
@@ -1025,47 +1037,77 @@ namespace OpenMS
       //
       // Now accept hypothesis
       //
+      accepted_hypos.emplace_back(hypo_idx, pass_isotope_filter);
 
-      Feature f;
-      f.setRT(feat_hypos[hypo_idx].getCentroidRT());
-      f.setMZ(feat_hypos[hypo_idx].getCentroidMZ());
+      // add used traces to exclusion map
+      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+      {
+        trace_excl_map.insert(labels[lab_idx]);
+      }
+    }
+
+    // *********************************************************** //
+    // Step 4 Create features from the accepted hypotheses in parallel,
+    // unique ids are drawn in order of acceptance as before
+    // *********************************************************** //
+    std::vector<UInt64> unique_ids(accepted_hypos.size());
+    for (Size i = 0; i < accepted_hypos.size(); ++i)
+    {
+      unique_ids[i] = UniqueIdGenerator::getUniqueId();
+    }
+    std::vector<Feature> features(accepted_hypos.size());
+    std::vector<std::vector<MSChromatogram> > chromatograms(accepted_hypos.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)accepted_hypos.size(); ++i)
+    {
+      const FeatureHypothesis& hypo = feat_hypos[accepted_hypos[i].first];
+      const int pass_isotope_filter = accepted_hypos[i].second;
+
+      Feature& f = features[i];
+      f.setRT(hypo.getCentroidRT());
+      f.setMZ(hypo.getCentroidMZ());
 
       if (report_summed_ints_)
       {
-        f.setIntensity(feat_hypos[hypo_idx].getSummedFeatureIntensity(use_smoothed_intensities_));
+        f.setIntensity(hypo.getSummedFeatureIntensity(use_smoothed_intensities_));
       }
       else
       {
-        f.setIntensity(feat_hypos[hypo_idx].getMonoisotopicFeatureIntensity(use_smoothed_intensities_));
+        f.setIntensity(hypo.getMonoisotopicFeatureIntensity(use_smoothed_intensities_));
       }
       
-      f.setWidth(feat_hypos[hypo_idx].getFWHM());
-      f.setCharge(feat_hypos[hypo_idx].getCharge());
-      f.setMetaValue(3, feat_hypos[hypo_idx].getLabel());
+      f.setWidth(hypo.getFWHM());
+      f.setCharge(hypo.getCharge());
+      f.setMetaValue(3, hypo.getLabel());
 
       // store isotope intensities
-      std::vector<double> all_ints(feat_hypos[hypo_idx].getAllIntensities(use_smoothed_intensities_));
+      std::vector<double> all_ints(hypo.getAllIntensities(use_smoothed_intensities_));
       f.setMetaValue("num_of_masstraces", all_ints.size());
-      if (report_convex_hulls_) f.setConvexHulls(feat_hypos[hypo_idx].getConvexHulls());
-      f.setOverallQuality(feat_hypos[hypo_idx].getScore());
+      if (report_convex_hulls_) f.setConvexHulls(hypo.getConvexHulls());
+      f.setOverallQuality(hypo.getScore());
       f.setMetaValue("masstrace_intensity", all_ints);
-      f.setMetaValue("masstrace_centroid_rt", feat_hypos[hypo_idx].getAllCentroidRT());
-      f.setMetaValue("masstrace_centroid_mz", feat_hypos[hypo_idx].getAllCentroidMZ());;
-      f.setMetaValue("isotope_distances", feat_hypos[hypo_idx].getIsotopeDistances());
+      f.setMetaValue("masstrace_centroid_rt", hypo.getAllCentroidRT());
+      f.setMetaValue("masstrace_centroid_mz", hypo.getAllCentroidMZ());;
+      f.setMetaValue("isotope_distances", hypo.getIsotopeDistances());
       f.setMetaValue("legal_isotope_pattern", pass_isotope_filter);
-      f.applyMemberFunction(&UniqueIdInterface::setUniqueId);
-      output_featmap.push_back(f);
+      f.setUniqueId(unique_ids[i]);
 
       if (report_chromatograms_ && f.getIntensity() != 0)
       {
-        output_chromatograms.push_back(feat_hypos[hypo_idx].getChromatograms(f.getUniqueId()));
+        chromatograms[i] = hypo.getChromatograms(f.getUniqueId());
       }
+    }
 
-      // add used traces to exclusion map
-      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+    output_featmap.reserve(features.size());
+    for (Size i = 0; i < features.size(); ++i)
+    {
+      if (report_chromatograms_ && features[i].getIntensity() != 0)
       {
-        trace_excl_map[labels[lab_idx]] = true;
+        output_chromatograms.push_back(std::move(chromatograms[i]));
       }
+      output_featmap.push_back(std::move(features[i]));
     }
     output_featmap.setUniqueId(UniqueIdGenerator::getUniqueId());
     output_featmap.sortByMZ();
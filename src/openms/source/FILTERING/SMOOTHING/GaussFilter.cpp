@@ -34,6 +34,10 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -60,4 +64,43 @@ namespace OpenMS
             (double)param_.getValue("ppm_tolerance"), param_.getValue("use_ppm_tolerance").toBool());
   }
 
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    // cannot throw inside the parallel region, check up front
+    if (param_.getValue("use_ppm_tolerance").toBool() && !map.getChromatograms().empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "GaussFilter: Cannot use ppm tolerance on chromatograms");
+    }
+
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      filter(map[i]);
+      IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+    }
+    std::vector<MSChromatogram>& chromatograms = map.getChromatograms();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+    {
+      filter(chromatograms[i]);
+      IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+    }
+    endProgress();
+  }
+
 }
@@ -57,17 +57,10 @@ namespace OpenMS
     use_ppm_tolerance_ = use_ppm_tolerance;
     ppm_tolerance_ = ppm_tolerance;
     sigma_ = gaussian_width / 8.0;
-    Size number_of_points_right = (Size)(ceil(4 * sigma_ / spacing_)) + 1;
-    coeffs_.resize(number_of_points_right);
-    coeffs_[0] = 1.0 / (sigma_ * sqrt(2.0 * Constants::PI));
-
-    for (Size i = 1; i < number_of_points_right; i++)
-    {
-      coeffs_[i] = 1.0 / (sigma_ * sqrt(2.0 * Constants::PI)) * exp(-((i * spacing_) * (i * spacing_)) / (2 * sigma_ * sigma_));
-    }
+    computeCoefficients_(sigma_, (Size)(ceil(4 * sigma_ / spacing_)) + 1, coeffs_);
 #ifdef DEBUG_FILTERING
     std::cout << "Coeffs: " << std::endl;
-    for (Size i = 0; i < number_of_points_right; i++)
+    for (Size i = 0; i < coeffs_.size(); i++)
     {
       std::cout << i * spacing_ << ' ' << coeffs_[i] << std::endl;
     }
@@ -75,4 +68,152 @@ namespace OpenMS
 
   }
 
+  void GaussFilterAlgorithm::computeCoefficients_(double sigma, Size number_of_points_right, std::vector<double>& coeffs) const
+  {
+    coeffs.resize(number_of_points_right);
+    coeffs[0] = 1.0 / (sigma * sqrt(2.0 * Constants::PI));
+
+    for (Size i = 1; i < number_of_points_right; i++)
+    {
+      coeffs[i] = 1.0 / (sigma * sqrt(2.0 * Constants::PI)) * exp(-((i * spacing_) * (i * spacing_)) / (2 * sigma * sigma));
+    }
+  }
+
+  void GaussFilterAlgorithm::updatePpmCoefficients_(double mz, int& piece, std::vector<double>& coeffs) const
+  {
+    const double sigma = mz * ppm_tolerance_ * 10e-6 / 8.0;
+    // the kernel size follows the exact width, so the integration window does not change
+    const Size number_of_points_right = (Size)(ceil(4 * sigma / spacing_)) + 1;
+    if (!(sigma > 0.0))
+    {
+      piece = std::numeric_limits<int>::min();
+      computeCoefficients_(sigma, number_of_points_right, coeffs);
+      return;
+    }
+
+    // relative step of the width grid, the width is off by at most 0.005% within a piece
+    const double log_step = std::log1p(1e-4);
+    const int current_piece = (int)std::floor(std::log(sigma) / log_step + 0.5);
+    if (current_piece != piece || coeffs.size() != number_of_points_right)
+    {
+      piece = current_piece;
+      computeCoefficients_(std::exp(current_piece * log_step), number_of_points_right, coeffs);
+    }
+  }
+
+  bool GaussFilterAlgorithm::hasPointsOnKernelBorder_(double data_spacing) const
+  {
+    const double border = coeffs_.size() * spacing_ / data_spacing;
+    return fabs(border - std::floor(border + 0.5)) < 1e-5 * std::max(1.0, border);
+  }
+
+  bool GaussFilterAlgorithm::filterEquidistant_(const std::vector<double>& intensities, double data_spacing, std::vector<double>& smoothed) const
+  {
+    const Size n = intensities.size();
+    smoothed.assign(n, 0.0);
+
+    // neighbours on each side which lie strictly within the kernel
+    const double half_width = coeffs_.size() * spacing_;
+    Size max_neighbours = 0;
+    while ((max_neighbours + 1) * data_spacing < half_width)
+    {
+      ++max_neighbours;
+    }
+    if (max_neighbours == 0 || n < 2)
+    {
+      return false;
+    }
+
+    std::vector<double> kernel(max_neighbours + 1);
+    for (Size k = 0; k <= max_neighbours; ++k)
+    {
+      kernel[k] = coefficient_(coeffs_, k * data_spacing);
+    }
+
+    // Weight of the data point k positions away, if the trapezoidal integration
+    // covers 'left' neighbours to the left and 'right' neighbours to the right.
+    // Inner points belong to two trapezoids, the outermost points to one. The
+    // common factor data_spacing / 2 cancels out in the normalization.
+    auto weight = [&kernel](Size k, Size neighbours)
+    {
+      if (k > neighbours || neighbours == 0) return 0.0;
+      return (k < neighbours) ? 2.0 * kernel[k] : kernel[k];
+    };
+    auto smoothPoint = [&](Size i, Size left, Size right)
+    {
+      double v = 0.0, norm = 0.0;
+      const double w_center = (left > 0 ? kernel[0] : 0.0) + (right > 0 ? kernel[0] : 0.0);
+      v += w_center * intensities[i];
+      norm += w_center;
+      for (Size k = 1; k <= left; ++k)
+      {
+        const double w = weight(k, left);
+        v += w * intensities[i - k];
+        norm += w;
+      }
+      for (Size k = 1; k <= right; ++k)
+      {
+        const double w = weight(k, right);
+        v += w * intensities[i + k];
+        norm += w;
+      }
+      return (v > 0) ? v / norm : 0.0;
+    };
+
+    // The integration window of a point ends before the first (last) data point
+    // if the kernel reaches beyond it, i.e. the boundary point itself is skipped.
+    auto neighbours = [max_neighbours](Size available)
+    {
+      return (available > max_neighbours) ? max_neighbours : (available > 0 ? available - 1 : 0);
+    };
+
+    // points at the borders, where the window is truncated
+    const Size inner_begin = std::min(max_neighbours + 1, n);
+    const Size inner_end = (n > max_neighbours + 1) ? std::max(n - max_neighbours - 1, inner_begin) : inner_begin;
+    for (Size i = 0; i < inner_begin; ++i)
+    {
+      smoothed[i] = smoothPoint(i, neighbours(i), neighbours(n - 1 - i));
+    }
+    for (Size i = inner_end; i < n; ++i)
+    {
+      smoothed[i] = smoothPoint(i, neighbours(i), neighbours(n - 1 - i));
+    }
+
+    // points with the full window: a fixed set of weights, convoluted in cache
+    // sized blocks with the data points in the inner (vectorizable) loop
+    const Size taps = 2 * max_neighbours + 1;
+    std::vector<double> weights(taps);
+    double norm = 0.0;
+    for (Size t = 0; t < taps; ++t)
+    {
+      const Size k = (t < max_neighbours) ? max_neighbours - t : t - max_neighbours;
+      weights[t] = (k == 0) ? 2.0 * kernel[0] : weight(k, max_neighbours);
+      norm += weights[t];
+    }
+    const Size block_size = 1024;
+    for (Size block_start = inner_begin; block_start < inner_end; block_start += block_size)
+    {
+      const Size block_end = std::min(block_start + block_size, inner_end);
+      for (Size t = 0; t < taps; ++t)
+      {
+        const double w = weights[t];
+        for (Size i = block_start; i < block_end; ++i)
+        {
+          smoothed[i] += w * intensities[i + t - max_neighbours];
+        }
+      }
+      for (Size i = block_start; i < block_end; ++i)
+      {
+        smoothed[i] = (smoothed[i] > 0) ? smoothed[i] / norm : 0.0;
+      }
+    }
+
+    bool found_signal = false;
+    for (Size i = 0; i < n; ++i)
+    {
+      if (fabs(smoothed[i]) > 0) found_signal = true;
+    }
+    return found_signal;
+  }
+
 }
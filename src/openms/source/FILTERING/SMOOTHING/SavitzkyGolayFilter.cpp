@@ -38,6 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -105,4 +109,120 @@ namespace OpenMS
       }
     }
   }
+
+  void SavitzkyGolayFilter::filter(MSSpectrum & spectrum)
+  {
+    filterContainer_(spectrum);
+  }
+
+  void SavitzkyGolayFilter::filter(MSChromatogram & chromatogram)
+  {
+    filterContainer_(chromatogram);
+  }
+
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map)
+  {
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      filterContainer_(map[i]);
+      IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+    }
+    std::vector<MSChromatogram>& chromatograms = map.getChromatograms();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+    {
+      filterContainer_(chromatograms[i]);
+      IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+    }
+    endProgress();
+  }
+
+  template <typename ContainerT>
+  void SavitzkyGolayFilter::filterContainer_(ContainerT & container) const
+  {
+    if (frame_size_ > container.size()) { return; }
+
+    std::vector<double> intensities(container.size());
+    for (Size p = 0; p < container.size(); ++p)
+    {
+      intensities[p] = container[p].getIntensity();
+    }
+
+    std::vector<double> smoothed;
+    filterIntensities_(intensities, smoothed);
+
+    for (Size p = 0; p < container.size(); ++p)
+    {
+      container[p].setIntensity(smoothed[p]);
+    }
+  }
+
+  void SavitzkyGolayFilter::filterIntensities_(const std::vector<double> & intensities, std::vector<double> & smoothed) const
+  {
+    const Size n = intensities.size();
+    const Size mid = frame_size_ / 2;
+    smoothed.assign(n, 0.0);
+
+    // compute the transient on: the first points use the leading rows of the coefficient matrix
+    for (Size i = 0; i <= mid; ++i)
+    {
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += intensities[j] * coeffs_[(i + 1) * frame_size_ - 1 - j];
+      }
+      smoothed[i] = std::max(0.0, help);
+    }
+
+    // compute the steady state output. The loops are interchanged (coefficients
+    // outside, data points inside) and run over blocks that fit into the cache,
+    // so the inner loop is a vectorizable multiply-add over contiguous data. The
+    // terms of each point are still summed in the same order as above.
+    const double* kernel = &coeffs_[mid * frame_size_];
+    const Size steady_end = n - mid;
+    const Size block_size = 1024;
+    for (Size block_start = mid + 1; block_start < steady_end; block_start += block_size)
+    {
+      const Size block_end = std::min(block_start + block_size, steady_end);
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        const double coeff = kernel[j];
+        for (Size i = block_start; i < block_end; ++i)
+        {
+          smoothed[i] += intensities[i + j - mid] * coeff;
+        }
+      }
+      for (Size i = block_start; i < block_end; ++i)
+      {
+        smoothed[i] = std::max(0.0, smoothed[i]);
+      }
+    }
+
+    // compute the transient off: the last points use the leading rows in reverse
+    for (Size k = 0; k < mid; ++k)
+    {
+      const Size i = mid - 1 - k; // row of the coefficient matrix
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += intensities[n - frame_size_ + j] * coeffs_[i * frame_size_ + j];
+      }
+      smoothed[steady_end + k] = std::max(0.0, help);
+    }
+  }
 }
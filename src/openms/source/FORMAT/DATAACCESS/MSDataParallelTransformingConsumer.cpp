@@ -0,0 +1,189 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /**
+      @brief Applies @p f to all elements of @p batch in parallel
+
+      Returns the index of the first element for which @p f threw (and stores
+      the exception in @p error) or the size of the batch if no error occurred.
+    */
+    template <typename DataT>
+    Size transformBatch(std::vector<DataT>& batch, const std::function<void (DataT&)>& f, std::exception_ptr& error)
+    {
+      Size first_error = batch.size();
+      if (!f) return first_error;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)batch.size(); ++i)
+      {
+        try
+        {
+          f(batch[i]);
+        }
+        catch (...)
+        {
+          // exceptions cannot leave the parallel region, keep the first one (in input order)
+#ifdef _OPENMP
+#pragma omp critical (MSDataParallelTransformingConsumer_error)
+#endif
+          {
+            if ((Size)i < first_error)
+            {
+              first_error = (Size)i;
+              error = std::current_exception();
+            }
+          }
+        }
+      }
+      return first_error;
+    }
+  }
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    MSDataTransformingConsumer(),
+    next_consumer_(next_consumer),
+    batch_size_(batch_size)
+  {
+    if (batch_size_ == 0)
+    {
+      // a few elements per thread keep all threads busy while bounding memory
+      batch_size_ = 64;
+#ifdef _OPENMP
+      batch_size_ *= (Size)omp_get_max_threads();
+#endif
+    }
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "Error while processing the remaining data: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+      OPENMS_LOG_ERROR << "Unknown error while processing the remaining data." << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const OpenMS::ExperimentalSettings& es)
+  {
+    MSDataTransformingConsumer::setExperimentalSettings(es);
+    next_consumer_->setExperimentalSettings(es);
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the input order between spectra and chromatograms
+    if (!chromatograms_.empty()) flushChromatograms_();
+
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the input order between spectra and chromatograms
+    if (!spectra_.empty()) flushSpectra_();
+
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    // at most one of the two buffers is non-empty
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  Size MSDataParallelTransformingConsumer::getBatchSize() const
+  {
+    return batch_size_;
+  }
+
+  void MSDataParallelTransformingConsumer::flushSpectra_()
+  {
+    std::vector<SpectrumType> batch;
+    batch.swap(spectra_);
+
+    std::exception_ptr error;
+    const Size nr_good = transformBatch(batch, lambda_spec_, error);
+    for (Size i = 0; i < nr_good; ++i)
+    {
+      next_consumer_->consumeSpectrum(batch[i]);
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+  void MSDataParallelTransformingConsumer::flushChromatograms_()
+  {
+    std::vector<ChromatogramType> batch;
+    batch.swap(chromatograms_);
+
+    std::exception_ptr error;
+    const Size nr_good = transformBatch(batch, lambda_chrom_, error);
+    for (Size i = 0; i < nr_good; ++i)
+    {
+      next_consumer_->consumeChromatogram(batch[i]);
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+} // namespace OpenMS
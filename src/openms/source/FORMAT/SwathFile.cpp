@@ -46,6 +46,12 @@
 #include <OpenMS/METADATA/ExperimentalSettings.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <cstdio> // for std::rename
+#include <fstream>
 #include <memory> // for make_shared
 
 namespace OpenMS
@@ -151,6 +157,30 @@ namespace OpenMS
     std::cout << "Loading mzML file " << file << " using readoptions " << readoptions << std::endl;
     String tmp_fname = tmp.hasSuffix('/') ? File::getUniqueName() : ""; // use tmp-filename if just a directory was given
 
+    bool persistent = (readoptions == "cachePersistent");
+    if (persistent)
+    {
+      std::vector<OpenSwath::SwathMap> swath_maps;
+      int nr_ms1_spectra;
+      if (loadPersistentCache_(file, tmp, exp_meta, nr_ms1_spectra, swath_maps))
+      {
+        std::cout << "Re-using persistent cache " << getPersistentCacheManifest_(file, tmp) << " for " << swath_maps.size() << " maps." << std::endl;
+        if (plugin_consumer)
+        {
+          // the plugin still needs to see the raw data, but the maps do not need to be written again
+          startProgress(0, 1, "Loading data file " + file);
+          exp_meta->setMetaValue("nr_ms1_spectra", nr_ms1_spectra); // required for SwathQC::getExpSettingsFunc()
+          plugin_consumer->setExperimentalSettings(*exp_meta.get());
+          exp_meta->removeMetaValue("nr_ms1_spectra");
+          MzMLFile().transform(file, plugin_consumer);
+          endProgress();
+        }
+        return swath_maps;
+      }
+      // cache is missing or stale: build it under a unique name so concurrent builders do not collide
+      tmp_fname = File::basename(file) + "_" + File::getUniqueName();
+    }
+
     startProgress(0, 1, "Loading metadata file " + file);
     boost::shared_ptr<PeakMap> exp_stripped = populateMetaData_(file);
     exp_meta = exp_stripped;
@@ -171,7 +201,7 @@ namespace OpenMS
     {
       dataConsumer = std::make_shared<RegularSwathFileConsumer>(known_window_boundaries);
     }
-    else if (readoptions == "cache")
+    else if (readoptions == "cache" || persistent)
     {
       dataConsumer = std::make_shared<CachedSwathFileConsumer>(known_window_boundaries, tmp, tmp_fname, nr_ms1_spectra, swath_counter);
     }
@@ -203,6 +233,10 @@ namespace OpenMS
     OPENMS_LOG_DEBUG << "Finished parsing Swath file " << std::endl;
     std::vector<OpenSwath::SwathMap> swath_maps;
     dataConsumer->retrieveSwathMaps(swath_maps);
+    if (persistent)
+    {
+      storePersistentCache_(file, tmp, tmp_fname, *exp_meta, nr_ms1_spectra, swath_maps);
+    }
     endProgress();
     return swath_maps;
   }
@@ -316,6 +350,173 @@ namespace OpenMS
     return SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
   }
 
+  String SwathFile::getPersistentCacheManifest_(const String& file, const String& tmp)
+  {
+    // files with the same name in different directories must not share a cache
+    QByteArray path = File::absolutePath(file).toQString().toUtf8();
+    String path_hash = String(QString(QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex().left(16)));
+    return tmp + File::basename(file) + "_" + path_hash + ".swathcache";
+  }
+
+  StringList SwathFile::getPersistentCacheKey_(const String& file)
+  {
+    QFileInfo info(file.toQString());
+    StringList key;
+    key.push_back("source\t" + File::absolutePath(file));
+    key.push_back("size\t" + String(static_cast<long long signed int>(info.size())));
+    key.push_back("modified\t" + String(static_cast<long long signed int>(info.lastModified().toMSecsSinceEpoch())));
+    return key;
+  }
+
+  void SwathFile::storePersistentCache_(const String& file, const String& tmp, const String& tmp_fname,
+                                        const ExperimentalSettings& settings, int nr_ms1_spectra,
+                                        const std::vector<OpenSwath::SwathMap>& swath_maps)
+  {
+    // the experimental settings are stored without spectra, so that re-using
+    // the cache does not require parsing the (large) raw file again
+    String settings_file = tmp_fname + "_settings.mzML";
+    PeakMap settings_only;
+    static_cast<ExperimentalSettings&>(settings_only) = settings;
+    MzMLFile().store(tmp + settings_file, settings_only);
+
+    // file names of the maps written by CachedSwathFileConsumer
+    Size ms2_counter = 0;
+    String manifest = getPersistentCacheManifest_(file, tmp);
+    String manifest_tmp = manifest + "." + File::getUniqueName() + ".tmp";
+    {
+      std::ofstream os(manifest_tmp.c_str());
+      os << "OpenSwathPersistentCache\t" << PERSISTENT_CACHE_VERSION << "\n";
+      for (const String& k : getPersistentCacheKey_(file)) os << k << "\n";
+      os << "nr_ms1_spectra\t" << nr_ms1_spectra << "\n";
+      os << "settings\t" << settings_file << "\n";
+      for (const OpenSwath::SwathMap& m : swath_maps)
+      {
+        String meta_file = m.ms1 ? tmp_fname + "_ms1.mzML" : tmp_fname + "_" + String(ms2_counter++) + ".mzML";
+        os << "map\t" << int(m.ms1) << "\t" << String(m.lower) << "\t" << String(m.upper) << "\t"
+           << String(m.center) << "\t" << meta_file << "\n";
+      }
+      if (!os)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, manifest_tmp);
+      }
+    }
+
+    // publish the manifest last: readers only ever see a complete cache
+    if (std::rename(manifest_tmp.c_str(), manifest.c_str()) != 0 && !File::rename(manifest_tmp, manifest, true, false))
+    {
+      File::remove(manifest_tmp);
+      OPENMS_LOG_WARN << "Warning: could not publish persistent cache " << manifest << ", it will not be re-used." << std::endl;
+    }
+  }
+
+  bool SwathFile::loadPersistentCache_(const String& file, const String& tmp,
+                                       boost::shared_ptr<ExperimentalSettings>& exp_meta, int& nr_ms1_spectra,
+                                       std::vector<OpenSwath::SwathMap>& swath_maps)
+  {
+    String manifest = getPersistentCacheManifest_(file, tmp);
+    std::vector<String> lines;
+    {
+      std::ifstream is(manifest.c_str());
+      if (!is)
+      {
+        return false;
+      }
+      std::string line;
+      while (std::getline(is, line))
+      {
+        lines.push_back(line);
+      }
+    }
+
+    String settings_file;
+    std::vector<OpenSwath::SwathMap> maps;
+    std::vector<String> meta_files;
+    auto parse = [&]() -> bool
+    {
+      StringList key = getPersistentCacheKey_(file);
+      if (lines.size() < key.size() + 3 || lines[0] != "OpenSwathPersistentCache\t" + String(PERSISTENT_CACHE_VERSION))
+      {
+        return false;
+      }
+      for (Size i = 0; i < key.size(); ++i)
+      {
+        if (lines[i + 1] != key[i]) return false;
+      }
+
+      std::vector<String> fields;
+      lines[key.size() + 1].split('\t', fields);
+      if (fields.size() != 2 || fields[0] != "nr_ms1_spectra") return false;
+      nr_ms1_spectra = fields[1].toInt();
+
+      lines[key.size() + 2].split('\t', fields);
+      if (fields.size() != 2 || fields[0] != "settings" || !File::readable(tmp + fields[1])) return false;
+      settings_file = tmp + fields[1];
+
+      for (Size i = key.size() + 3; i < lines.size(); ++i)
+      {
+        lines[i].split('\t', fields);
+        if (fields.size() != 6 || fields[0] != "map") return false;
+        String meta_file = tmp + fields[5];
+        if (!File::readable(meta_file) || !File::readable(meta_file + ".cached")) return false;
+
+        OpenSwath::SwathMap m;
+        m.ms1 = (fields[1] == "1");
+        m.lower = fields[2].toDouble();
+        m.upper = fields[3].toDouble();
+        m.center = fields[4].toDouble();
+        maps.push_back(m);
+        meta_files.push_back(meta_file);
+      }
+      return true;
+    };
+
+    if (!parse())
+    {
+      std::cout << "Persistent cache " << manifest << " is out of date or incomplete and will be rebuilt." << std::endl;
+      removePersistentCache_(manifest, tmp, lines);
+      return false;
+    }
+
+    // all files are present: only the (small) metadata needs to be parsed,
+    // the spectra are read on demand from the shared, read-only cached files
+    boost::shared_ptr<PeakMap> settings(new PeakMap);
+    MzMLFile().load(settings_file, *settings);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(maps.size()); ++i)
+    {
+      boost::shared_ptr<PeakMap> exp(new PeakMap);
+      MzMLFile().load(meta_files[i], *exp);
+      maps[i].sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    }
+
+    exp_meta = settings;
+    swath_maps.swap(maps);
+    return true;
+  }
+
+  void SwathFile::removePersistentCache_(const String& manifest, const String& tmp, const std::vector<String>& lines)
+  {
+    // remove the manifest first, so that no other process starts using the files removed below
+    File::remove(manifest);
+    std::vector<String> fields;
+    for (const String& line : lines)
+    {
+      line.split('\t', fields);
+      if (fields.size() == 2 && fields[0] == "settings")
+      {
+        File::remove(tmp + fields[1]);
+      }
+      else if (fields.size() == 6 && fields[0] == "map")
+      {
+        File::remove(tmp + fields[5]);
+        File::remove(tmp + fields[5] + ".cached");
+      }
+    }
+  }
+
   /// Only read the meta data from a file and use it to populate exp_meta
   boost::shared_ptr< PeakMap > SwathFile::populateMetaData_(const String& file)
   {
@@ -231,9 +231,10 @@ namespace OpenMS
       }
       else                   //HighRes data
       {
+        //the zero-padded spectrum does not depend on the charge state, so we build it only once per scan
+        MSSpectrum* new_spec = createHRData(i);
         for (UInt c = 0; c < max_charge_; ++c)
         {
-          MSSpectrum* new_spec = createHRData(i);
           iwt->initializeScan(*new_spec, c);
           MSSpectrum c_trans(*new_spec);
 
@@ -261,9 +262,8 @@ namespace OpenMS
           std::cout << "charge recognition O.K. ... "; std::cout.flush();
 #endif
           this->ff_->setProgress(++progress_counter_);
-
-          delete (new_spec); new_spec = nullptr;
         }
+        delete (new_spec); new_spec = nullptr;
       }
 
 
@@ -50,6 +50,7 @@
 #include <QtCore/QDir>
 
 #ifdef _OPENMP
+#include <omp.h>
 #endif
 
 namespace OpenMS
@@ -217,12 +218,25 @@ namespace OpenMS
     double user_mz_tol = param_.getValue("user-seed:mz_tolerance");
     double user_seed_score = param_.getValue("user-seed:min_score");
 
+    debug_ = ((String)(param_.getValue("debug")) == "true");
+    //clean up / create folders for debug information
+    if (debug_)
+    {
+      QDir dir(".");
+      dir.mkpath("debug/features");
+      log_.open("debug/log.txt");
+    }
+
     //reserve space for calculated scores
+    // The pattern and overall scores are only needed while the seeds of one
+    // charge are processed, so a single pair of arrays is reused for all
+    // charges. Only the debug output keeps the scores of every charge.
     UInt charge_count = charge_high - charge_low + 1;
+    UInt score_charge_count = debug_ ? charge_count : 1;
     for (auto& s : map_)
     {
       Size scan_size = s.size();
-      s.getFloatDataArrays().resize(3 + 2 * charge_count);
+      s.getFloatDataArrays().resize(3 + 2 * score_charge_count);
       s.getFloatDataArrays()[0].setName("trace_score");
       s.getFloatDataArrays()[0].assign(scan_size, 0.0);
       s.getFloatDataArrays()[1].setName("intensity_score");
@@ -231,31 +245,22 @@ namespace OpenMS
       s.getFloatDataArrays()[2].assign(scan_size, 0.0);
       //create isotope pattern score arrays
       UInt charge = charge_low;
-      for (Size i = 3; i < 3 + charge_count; ++i)
+      for (Size i = 3; i < 3 + score_charge_count; ++i)
       {
-        s.getFloatDataArrays()[i].setName(String("pattern_score_") + charge);
+        s.getFloatDataArrays()[i].setName(debug_ ? String("pattern_score_") + charge : String("pattern_score"));
         s.getFloatDataArrays()[i].assign(scan_size, 0.0);
         ++charge;
       }
       //create overall score arrays
       charge = charge_low;
-      for (Size i = 3 + charge_count; i < 3 + 2 * charge_count; ++i)
+      for (Size i = 3 + score_charge_count; i < 3 + 2 * score_charge_count; ++i)
       {
-        s.getFloatDataArrays()[i].setName(String("overall_score_") + charge);
+        s.getFloatDataArrays()[i].setName(debug_ ? String("overall_score_") + charge : String("overall_score"));
         s.getFloatDataArrays()[i].assign(scan_size, 0.0);
         ++charge;
       }
     }
 
-    debug_ = ((String)(param_.getValue("debug")) == "true");
-    //clean up / create folders for debug information
-    if (debug_)
-    {
-      QDir dir(".");
-      dir.mkpath("debug/features");
-      log_.open("debug/log.txt");
-    }
-
     //---------------------------------------------------------------------------
     //Step 1:
     //Precalculate intensity scores for peaks
@@ -269,7 +274,9 @@ namespace OpenMS
       intensity_rt_step_ = (map_.getMaxRT() - rt_start) / (double)intensity_bins_;
       intensity_mz_step_ = (map_.getMaxMZ() - mz_start) / (double)intensity_bins_;
       intensity_thresholds_.resize(intensity_bins_);
-      for (Size rt = 0; rt < intensity_bins_; ++rt)
+      // the RT bins are independent (the map is only read)
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize rt = 0; rt < (SignedSize)intensity_bins_; ++rt)
       {
         intensity_thresholds_[rt].resize(intensity_bins_);
         double min_rt = rt_start + rt * intensity_rt_step_;
@@ -277,7 +284,7 @@ namespace OpenMS
         std::vector<double> tmp;
         for (Size mz = 0; mz < intensity_bins_; ++mz)
         {
-          ff_->setProgress(rt * intensity_bins_ + mz);
+          IF_MASTERTHREAD ff_->setProgress(rt * intensity_bins_ + mz);
           double min_mz = mz_start + mz * intensity_mz_step_;
           double max_mz = mz_start + (mz + 1) * intensity_mz_step_;
           //std::cout << "rt range: " << min_rt << " - " << max_rt << std::endl;
@@ -303,7 +310,8 @@ namespace OpenMS
       }
 
       //store intensity score in PeakInfo
-      for (Size s = 0; s < map_.size(); ++s)
+#pragma omp parallel for schedule(dynamic, 16)
+      for (SignedSize s = 0; s < (SignedSize)map_.size(); ++s)
       {
         for (Size p = 0; p < map_[s].size(); ++p)
         {
@@ -322,9 +330,11 @@ namespace OpenMS
       Size end_iteration = map_.size() - std::min((Size) min_spectra_, map_.size());
       ff_->startProgress(min_spectra_, end_iteration, "Precalculating mass trace scores");
       // skip first and last scans since we cannot extend the mass traces there
-      for (Size s = min_spectra_; s < end_iteration; ++s)
+      // (each scan only writes its own scores, the neighbouring scans are read)
+#pragma omp parallel for schedule(dynamic, 16)
+      for (SignedSize s = min_spectra_; s < (SignedSize)end_iteration; ++s)
       {
-        ff_->setProgress(s);
+        IF_MASTERTHREAD ff_->setProgress(s);
         SpectrumType& spectrum = map_[s];
         //iterate over all peaks of the scan
         for (Size p = 0; p < spectrum.size(); ++p)
@@ -338,7 +348,7 @@ namespace OpenMS
           bool is_max_peak = true; //checking the maximum intensity peaks -> use them later as feature seeds.
           for (Size i = 1; i <= min_spectra_; ++i)
           {
-            SpectrumType& next_spectrum = map_[s + i];
+            const SpectrumType& next_spectrum = map_[s + i];
             if (!next_spectrum.empty()) // There are peaks in the spectrum
             {
               Size spec_index = next_spectrum.findNearest(pos);
@@ -349,7 +359,7 @@ namespace OpenMS
           }
           for (Size i = 1; i <= min_spectra_; ++i)
           {
-            SpectrumType& next_spectrum = map_[s - i];
+            const SpectrumType& next_spectrum = map_[s - i];
             if (!next_spectrum.empty()) // There are peaks in the spectrum
             {
               Size spec_index = next_spectrum.findNearest(pos);
@@ -383,7 +393,8 @@ namespace OpenMS
       isotope_distributions_.resize(num_isotopes);
 
       //calculate distribution if necessary
-      for (Size index = 0; index < num_isotopes; ++index)
+#pragma omp parallel for schedule(dynamic, 16)
+      for (SignedSize index = 0; index < (SignedSize)num_isotopes; ++index)
       {
         //if(debug_) log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
         CoarseIsotopePatternGenerator solver(max_isotopes);
@@ -451,8 +462,17 @@ namespace OpenMS
     Int feature_nr_global = 0; //counter for the number of features (debug info)
     for (SignedSize c = charge_low; c <= charge_high; ++c)
     {
-      UInt meta_index_isotope = 3 + c - charge_low;
-      UInt meta_index_overall = 3 + charge_count + c - charge_low;
+      UInt meta_index_isotope = debug_ ? 3 + c - charge_low : 3;
+      UInt meta_index_overall = debug_ ? 3 + charge_count + c - charge_low : 4;
+      if (!debug_)
+      {
+        // reset the scores of the previous charge
+        for (auto& s : map_)
+        {
+          std::fill(s.getFloatDataArrays()[meta_index_isotope].begin(), s.getFloatDataArrays()[meta_index_isotope].end(), 0.0);
+          std::fill(s.getFloatDataArrays()[meta_index_overall].begin(), s.getFloatDataArrays()[meta_index_overall].end(), 0.0);
+        }
+      }
 
       Size feature_candidates = 0;
       std::vector<Seed> seeds;
@@ -461,42 +481,80 @@ namespace OpenMS
       //Step 3.1: Precalculate IsotopePattern score
       //-----------------------------------------------------------
       ff_->startProgress(0, map_.size(), String("Calculating isotope pattern scores for charge ") + String(c));
-      for (Size s = 0; s < map_.size(); ++s)
+      // A pattern updates the scores of peaks in adjacent spectra. The patterns
+      // of a block of spectra are therefore scored in parallel and the updates
+      // are applied afterwards. Keeping the maximum score does not depend on
+      // the order of the updates.
+      struct PatternScoreUpdate
       {
-        ff_->setProgress(s);
-        const SpectrumType& spectrum = map_[s];
-        for (Size p = 0; p < spectrum.size(); ++p)
+        Size spectrum;
+        Size peak;
+        double score;
+      };
+      Size block_size = 64;
+#ifdef _OPENMP
+      block_size *= omp_get_max_threads();
+#endif
+      std::vector<std::vector<PatternScoreUpdate> > pattern_updates;
+      for (Size block_start = 0; block_start < map_.size(); block_start += block_size)
+      {
+        Size block_end = std::min(block_start + block_size, map_.size());
+        pattern_updates.assign(block_end - block_start, std::vector<PatternScoreUpdate>());
+        ff_->setProgress(block_start);
+
+        // the debug log is written while finding isotopes
+#pragma omp parallel for schedule(dynamic, 1) if (!debug_)
+        for (SignedSize s = block_start; s < (SignedSize)block_end; ++s)
         {
-          double mz = spectrum[p].getMZ();
+          const SpectrumType& spectrum = map_[s];
+          std::vector<PatternScoreUpdate>& updates = pattern_updates[s - block_start];
+          for (Size p = 0; p < spectrum.size(); ++p)
+          {
+            double mz = spectrum[p].getMZ();
 
-          //get isotope distribution for this mass
-          const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
-          //determine highest peak in isotope distribution
-          Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
-          //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
-          Size peak_index = spectrum.findNearest(mz - ((double)(isotopes.size() + 1) / c));
-          IsotopePattern pattern(isotopes.size());
+            //get isotope distribution for this mass
+            const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
+            //determine highest peak in isotope distribution
+            Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
+            //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
+            Size peak_index = spectrum.findNearest(mz - ((double)(isotopes.size() + 1) / c));
+            IsotopePattern pattern(isotopes.size());
 
-          for (Size i = 0; i < isotopes.size(); ++i)
-          {
-            double isotope_pos = mz + ((double)i - max_isotope) / c;
-            findIsotope_(isotope_pos, s, pattern, i, peak_index);
-          }
+            for (Size i = 0; i < isotopes.size(); ++i)
+            {
+              double isotope_pos = mz + ((double)i - max_isotope) / c;
+              findIsotope_(isotope_pos, s, pattern, i, peak_index);
+            }
 
-          double pattern_score = isotopeScore_(isotopes, pattern, true);
+            double pattern_score = isotopeScore_(isotopes, pattern, true);
 
-          //update pattern scores of all contained peaks (if necessary)
-          if (pattern_score > 0.0)
-          {
-            for (Size i = 0; i < pattern.peak.size(); ++i)
+            //remember the pattern score for all contained peaks
+            if (pattern_score > 0.0)
             {
-              if (pattern.peak[i] >= 0 && pattern_score > map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]])
+              for (Size i = 0; i < pattern.peak.size(); ++i)
               {
-                map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]] = pattern_score;
+                if (pattern.peak[i] >= 0)
+                {
+                  PatternScoreUpdate update = { (Size)pattern.spectrum[i], (Size)pattern.peak[i], pattern_score };
+                  updates.push_back(update);
+                }
               }
             }
           }
         }
+
+        //update pattern scores of all contained peaks (if necessary)
+        for (const auto& updates : pattern_updates)
+        {
+          for (const PatternScoreUpdate& update : updates)
+          {
+            float& score = map_[update.spectrum].getFloatDataArrays()[meta_index_isotope][update.peak];
+            if (update.score > score)
+            {
+              score = update.score;
+            }
+          }
+        }
       }
       ff_->endProgress();
       //-----------------------------------------------------------
@@ -508,9 +566,13 @@ namespace OpenMS
 
       double min_seed_score = param_.getValue("seed:min_score");
       //do nothing for the first few and last few spectra as the scans required to search for traces are missing
-      for (Size s = min_spectra_; s < end_of_iteration; ++s)
+      // (the seeds of each spectrum are collected separately and concatenated in spectrum order)
+      std::vector<std::vector<Seed> > seeds_per_spectrum(end_of_iteration > min_spectra_ ? end_of_iteration - min_spectra_ : 0);
+#pragma omp parallel for schedule(dynamic, 16)
+      for (SignedSize s = min_spectra_; s < (SignedSize)end_of_iteration; ++s)
       {
-        ff_->setProgress(s);
+        IF_MASTERTHREAD ff_->setProgress(s);
+        std::vector<Seed>& spectrum_seeds = seeds_per_spectrum[s - min_spectra_];
 
         //iterate over peaks
         for (Size p = 0; p < map_[s].size(); ++p)
@@ -529,7 +591,7 @@ namespace OpenMS
               seed.spectrum = s;
               seed.peak = p;
               seed.intensity = map_[s][p].getIntensity();
-              seeds.push_back(seed);
+              spectrum_seeds.push_back(seed);
             }
             //user-specified seeds: overall score greater than USER min seed score
             else if (user_seeds && overall_score >= user_seed_score)
@@ -550,7 +612,7 @@ namespace OpenMS
                   seed.spectrum = s;
                   seed.peak = p;
                   seed.intensity = map_[s][p].getIntensity();
-                  seeds.push_back(seed);
+                  spectrum_seeds.push_back(seed);
                   break;
                 }
               }
@@ -558,6 +620,10 @@ namespace OpenMS
           }
         }
       }
+      for (const auto& spectrum_seeds : seeds_per_spectrum)
+      {
+        seeds.insert(seeds.end(), spectrum_seeds.begin(), spectrum_seeds.end());
+      }
       //sort seeds according to intensity
       std::sort(seeds.rbegin(), seeds.rend());
       //create and store seeds map and selected peak map
@@ -606,6 +672,14 @@ namespace OpenMS
       int gl_progress = 0;
       ff_->startProgress(0, seeds.size(), String("Extending seeds for charge ") + String(c));
 
+      // seed indices sorted by m/z, to look up the seeds inside a feature
+      std::vector<std::pair<double, Size> > seeds_by_mz(seeds.size());
+      for (Size j = 0; j < seeds.size(); ++j)
+      {
+        seeds_by_mz[j] = std::make_pair(map_[seeds[j].spectrum][seeds[j].peak].getMZ(), j);
+      }
+      std::sort(seeds_by_mz.begin(), seeds_by_mz.end());
+
 #pragma omp parallel for
       for (SignedSize i = 0; i < (SignedSize)seeds.size(); ++i)
       {
@@ -811,16 +885,26 @@ namespace OpenMS
         //----------------------------------------------------------------
         //Remember all seeds that lie inside the convex hull of the new feature
         DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
-        for (Size j = i + 1; j < seeds.size(); ++j)
+        std::vector<Size> contained_seeds;
+        std::vector<std::pair<double, Size> >::const_iterator mz_it = std::lower_bound(seeds_by_mz.begin(), seeds_by_mz.end(),
+                                                                                       std::make_pair(bb.minPosition()[1], Size(0)));
+        for (; mz_it != seeds_by_mz.end() && mz_it->first <= bb.maxPosition()[1]; ++mz_it)
         {
+          Size j = mz_it->second;
+          if (j <= (Size)i) continue;
           double rt = map_[seeds[j].spectrum].getRT();
-          double mz = map_[seeds[j].spectrum][seeds[j].peak].getMZ();
+          double mz = mz_it->first;
           if (bb.encloses(rt, mz) && f.encloses(rt, mz))
           {
+            contained_seeds.push_back(j);
+          }
+        }
+        if (!contained_seeds.empty())
+        {
+          std::sort(contained_seeds.begin(), contained_seeds.end());
 #pragma omp critical (FeatureFinderAlgorithmPicked_SEEDSINFEATURES)
-            {
-              seeds_in_features[i].push_back(j);
-            }
+          {
+            seeds_in_features[i].swap(contained_seeds);
           }
         }
       } // end of OPENMP over seeds
@@ -829,16 +913,11 @@ namespace OpenMS
       // features of seeds with higher intensities. Only if the seed is not
       // used in any feature with higher intensity, we can add it to the
       // features_ list.
-      std::vector<Size> seeds_contained;
+      std::vector<bool> seeds_contained(seeds.size(), false);
       for (auto& f : tmp_feature_map)
       {
         Size seed_nr = f.first;
-        bool is_used = false;
-        for (Size i : seeds_contained)
-        {
-          if (seed_nr == i) { is_used = true; break; }
-        }
-        if (!is_used)
+        if (!seeds_contained[seed_nr])
         {
           ++feature_candidates;
 
@@ -847,10 +926,9 @@ namespace OpenMS
           ++feature_nr_global;
           features_->push_back(f.second);
 
-          std::vector<Size> curr_seed = seeds_in_features[seed_nr];
-          for (Size k : curr_seed)
+          for (Size k : seeds_in_features[seed_nr])
           {
-            seeds_contained.push_back(k);
+            seeds_contained[k] = true;
           }
         }
       }
@@ -1037,9 +1115,13 @@ namespace OpenMS
   /// Writes the abort reason to the log file and counts occurrences for each reason
   void FeatureFinderAlgorithmPicked::abort_(const Seed& seed, const String& reason)
   {
-    if (debug_) log_ << "Abort: " << reason << std::endl;
-    aborts_[reason]++;
-    if (debug_) abort_reasons_[seed] = reason;
+    // called while seeds are extended in parallel
+#pragma omp critical (FeatureFinderAlgorithmPicked_ABORT)
+    {
+      if (debug_) log_ << "Abort: " << reason << std::endl;
+      aborts_[reason]++;
+      if (debug_) abort_reasons_[seed] = reason;
+    }
   }
 
   double FeatureFinderAlgorithmPicked::intersection_(const Feature& f1, const Feature& f2) const
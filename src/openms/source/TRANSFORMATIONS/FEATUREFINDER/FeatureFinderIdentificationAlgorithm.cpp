@@ -40,6 +40,7 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractor.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/ANALYSIS/SVM/SimpleSVM.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmIdentification.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
@@ -52,6 +53,7 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <exception>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -228,8 +230,12 @@ namespace OpenMS
     feat_finder_.setParameters(params);
     feat_finder_.setLogType(ProgressLogger::NONE);
     feat_finder_.setStrictFlag(false);
-    // to use MS1 Swath scores:
-    feat_finder_.setMS1Map(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(boost::make_shared<MSExperiment>(ms_data_)));
+    // (each chunk uses its own feature finder with these settings, see detectFeaturesInChunk_)
+
+    // one copy of the data serves for chromatogram extraction and MS1 scores:
+    boost::shared_ptr<PeakMap> shared = boost::make_shared<PeakMap>(ms_data_);
+    OpenSwath::SpectrumAccessPtr spec_temp =
+        SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
 
     double rt_uncertainty(0);
     bool with_external_ids = !peptides_ext.empty();
@@ -371,9 +377,6 @@ namespace OpenMS
     }
     n_external_peps_ = peptide_map_.size() - n_internal_peps_;
 
-    boost::shared_ptr<PeakMap> shared = boost::make_shared<PeakMap>(ms_data_);
-    OpenSwath::SpectrumAccessPtr spec_temp =
-        SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
     auto chunks = chunk_(peptide_map_.begin(), peptide_map_.end(), batch_size_);
 
     PeptideRefRTMap ref_rt_map;
@@ -394,48 +397,77 @@ namespace OpenMS
     //-------------------------------------------------------------
     //Note: progress only works in non-debug when no logs come in-between
     getProgressLogger().startProgress(0, chunks.size(), "Creating assay library and extracting chromatograms");
-    Size chunk_count = 0;
-    for (auto& chunk : chunks)
+    // suppress status output from OpenSWATH, unless in debug mode:
+    if (debug_level_ < 1) OpenMS_Log_info.remove(cout);
+
+    // Chunks are processed in groups of one chunk per thread. The assay
+    // libraries of a group are created serially (they share ref_rt_map and
+    // isotope_probs_), then chromatograms are extracted and scored in
+    // parallel and the features are added in chunk order.
+    Size chunks_per_group = 1;
+#ifdef _OPENMP
+    chunks_per_group = (Size)omp_get_max_threads();
+#endif
+    for (Size group_start = 0; group_start < chunks.size(); group_start += chunks_per_group)
     {
-      //TODO since ref_rt_map is only used after chunking, we could create
-      // maps per chunk and merge them in the end. Would help in parallelizing as well.
-      createAssayLibrary_(chunk.first, chunk.second, ref_rt_map);
-      OPENMS_LOG_DEBUG << "#Transitions: " << library_.getTransitions().size() << endl;
-
-      ChromatogramExtractor extractor;
-      // extractor.setLogType(ProgressLogger::NONE);
+      const Size group_end = std::min(group_start + chunks_per_group, chunks.size());
+      std::vector<TargetedExperiment> libraries(group_end - group_start);
+      for (Size i = 0; i < libraries.size(); ++i)
       {
-        vector<OpenSwath::ChromatogramPtr> chrom_temp;
-        vector<ChromatogramExtractor::ExtractionCoordinates> coords;
-        // take entries in library_ and put to chrom_temp and coords
-        extractor.prepare_coordinates(chrom_temp, coords, library_,
-                                      numeric_limits<double>::quiet_NaN(), false);
-
-
-        extractor.extractChromatograms(spec_temp, chrom_temp, coords, mz_window_,
-                                       mz_window_ppm_, "tophat");
-        extractor.return_chromatogram(chrom_temp, coords, library_, (*shared)[0],
-                                      chrom_data_.getChromatograms(), false);
+        createAssayLibrary_(chunks[group_start + i].first, chunks[group_start + i].second, ref_rt_map);
+        OPENMS_LOG_DEBUG << "#Transitions: " << library_.getTransitions().size() << endl;
+        libraries[i] = library_;
+        library_.clear(true);
       }
 
-      OPENMS_LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
-                       << " chromatogram(s)." << endl;
+      std::vector<FeatureMap> chunk_features(libraries.size());
+      std::vector<Size> chunk_nr_chromatograms(libraries.size(), 0);
+      std::vector<std::vector<MSChromatogram> > chunk_chromatograms(keep_chromatograms_ ? libraries.size() : 0);
+      std::vector<std::exception_ptr> errors(libraries.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)libraries.size(); ++i)
+      {
+        try
+        {
+          chunk_nr_chromatograms[i] = detectFeaturesInChunk_(libraries[i], spec_temp, (*shared)[0], chunk_features[i],
+                                                             keep_chromatograms_ ? &chunk_chromatograms[i] : nullptr);
+        }
+        catch (...)
+        {
+          // cannot throw inside the parallel region
+          errors[i] = std::current_exception();
+        }
+      }
 
-      OPENMS_LOG_DEBUG << "Detecting chromatographic peaks..." << endl;
-      // suppress status output from OpenSWATH, unless in debug mode:
-      if (debug_level_ < 1) OpenMS_Log_info.remove(cout);
-      feat_finder_.pickExperiment(chrom_data_, features, library_,
-                                  TransformationDescription(), ms_data_);
-      if (debug_level_ < 1) OpenMS_Log_info.insert(cout); // revert logging change
-      chrom_data_.clear(true);
-      library_.clear(true);
-      // since chrom_data_ here is just a container for the chromatograms and identifications will be empty,
-      // pickExperiment above will only add empty ProteinIdentification runs with colliding identifiers.
-      // Usually we could sanitize the identifiers or merge the runs, but since they are empty and we add the
-      // "real" proteins later -> just clear them
-      features.getProteinIdentifications().clear();
-      getProgressLogger().setProgress(++chunk_count);
+      for (Size i = 0; i < libraries.size(); ++i)
+      {
+        if (errors[i])
+        {
+          if (debug_level_ < 1) OpenMS_Log_info.insert(cout); // revert logging change
+          std::rethrow_exception(errors[i]);
+        }
+        // logged here, since the log streams must not be written from the parallel region
+        OPENMS_LOG_DEBUG << "Extracted " << chunk_nr_chromatograms[i] << " chromatogram(s) and detected "
+                         << chunk_features[i].size() << " feature(s)." << endl;
+        for (Feature& feature : chunk_features[i])
+        {
+          // unique ids were drawn concurrently, reassign them in chunk order
+          if (libraries.size() > 1) feature.applyMemberFunction(&UniqueIdInterface::setUniqueId);
+          features.push_back(std::move(feature));
+        }
+        if (keep_chromatograms_)
+        {
+          for (MSChromatogram& chrom : chunk_chromatograms[i])
+          {
+            chrom_data_.addChromatogram(std::move(chrom));
+          }
+        }
+      }
+      getProgressLogger().setProgress(group_end);
     }
+    if (debug_level_ < 1) OpenMS_Log_info.insert(cout); // revert logging change
     getProgressLogger().endProgress();
 
     OPENMS_LOG_INFO << "Found " << features.size() << " feature candidates in total."
@@ -829,6 +861,59 @@ namespace OpenMS
     }
   }
 
+  Size FeatureFinderIdentificationAlgorithm::detectFeaturesInChunk_(const TargetedExperiment& library, const OpenSwath::SpectrumAccessPtr& ms_map,
+                                                                   const MSSpectrum& template_spectrum, FeatureMap& chunk_features,
+                                                                   std::vector<MSChromatogram>* chunk_chromatograms) const
+  {
+    boost::shared_ptr<PeakMap> chrom_data = boost::make_shared<PeakMap>();
+    ChromatogramExtractor extractor;
+    // extractor.setLogType(ProgressLogger::NONE);
+    {
+      vector<OpenSwath::ChromatogramPtr> chrom_temp;
+      vector<ChromatogramExtractor::ExtractionCoordinates> coords;
+      // take entries in library and put to chrom_temp and coords
+      extractor.prepare_coordinates(chrom_temp, coords, library,
+                                    numeric_limits<double>::quiet_NaN(), false);
+
+      extractor.extractChromatograms(ms_map, chrom_temp, coords, mz_window_,
+                                     mz_window_ppm_, "tophat");
+      extractor.return_chromatogram(chrom_temp, coords, library, template_spectrum,
+                                    chrom_data->getChromatograms(), false);
+    }
+
+    const Size nr_chromatograms = chrom_data->getNrChromatograms();
+
+    // score on the shared map directly (the PeakMap interface of
+    // MRMFeatureFinderScoring would copy the whole map for every chunk)
+    MRMFeatureFinderScoring feat_finder;
+    feat_finder.setParameters(feat_finder_.getParameters());
+    feat_finder.setLogType(ProgressLogger::NONE);
+    feat_finder.setStrictFlag(false);
+    // to use MS1 Swath scores:
+    feat_finder.setMS1Map(ms_map->lightClone());
+
+    OpenSwath::LightTargetedExperiment transition_exp;
+    OpenSwathDataAccessHelper::convertTargetedExp(library, transition_exp);
+    OpenSwath::SwathMap swath_map;
+    swath_map.sptr = ms_map->lightClone();
+    std::vector<OpenSwath::SwathMap> swath_maps(1, swath_map);
+    MRMFeatureFinderScoring::TransitionGroupMapType transition_group_map;
+    feat_finder.pickExperiment(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(chrom_data),
+                               chunk_features, transition_exp, TransformationDescription(),
+                               swath_maps, transition_group_map);
+    // since chunk_features is just a container for the features and identifications will be empty,
+    // pickExperiment above will only add empty ProteinIdentification runs with colliding identifiers.
+    // Usually we could sanitize the identifiers or merge the runs, but since they are empty and we add the
+    // "real" proteins later -> just clear them
+    chunk_features.getProteinIdentifications().clear();
+
+    if (chunk_chromatograms != nullptr)
+    {
+      chunk_chromatograms->swap(chrom_data->getChromatograms());
+    }
+    return nr_chromatograms;
+  }
+
   void FeatureFinderIdentificationAlgorithm::getRTRegions_(
     ChargeMap& peptide_data,
     std::vector<RTRegion>& rt_regions,
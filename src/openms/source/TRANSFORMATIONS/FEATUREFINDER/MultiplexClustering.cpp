@@ -44,6 +44,12 @@
 
 #include<QDir>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -176,17 +182,42 @@ namespace OpenMS
     unsigned progress = 0;
     startProgress(0, filter_results.size(), "clustering filtered LC-MS data");
       
-    std::vector<std::map<int, GridBasedCluster> > cluster_results;
+    std::vector<std::map<int, GridBasedCluster> > cluster_results(filter_results.size());
+    std::vector<std::exception_ptr> errors(filter_results.size());
 
     // loop over patterns i.e. cluster each of the corresponding filter results
-    for (unsigned i = 0; i < filter_results.size(); ++i)
+    // (The patterns are independent of each other and of very different size, hence the dynamic schedule.)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize i = 0; i < (SignedSize) filter_results.size(); ++i)
+    {
+      try
+      {
+        GridBasedClustering<MultiplexDistance> clustering(MultiplexDistance(rt_scaling_), filter_results[i].getMZ(), filter_results[i].getRT(), grid_spacing_mz_, grid_spacing_rt_);
+        clustering.cluster();
+        //clustering.extendClustersY();
+        cluster_results[i] = clustering.getResults();
+      }
+      catch (...)
+      {
+        // cannot throw inside the parallel region
+        errors[i] = std::current_exception();
+      }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+      IF_MASTERTHREAD setProgress(progress);
+    }
+
+    for (Size i = 0; i < errors.size(); ++i)
     {
-      setProgress(++progress);
-        
-      GridBasedClustering<MultiplexDistance> clustering(MultiplexDistance(rt_scaling_), filter_results[i].getMZ(), filter_results[i].getRT(), grid_spacing_mz_, grid_spacing_rt_);
-      clustering.cluster();
-      //clustering.extendClustersY();
-      cluster_results.push_back(clustering.getResults());
+      if (errors[i])
+      {
+        std::rethrow_exception(errors[i]);
+      }
     }
 
     endProgress();
@@ -41,6 +41,10 @@
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -429,60 +433,97 @@ namespace OpenMS
     // MSLevel -> stats
     map<int, SpectraPickInfo> pick_info;
 
-    if (input.getNrSpectra() > 0)
+    // Spectra are independent and picked in parallel. The boundaries are
+    // collected per scan and appended in scan order afterwards, so the
+    // output does not depend on the number of threads.
+    std::vector<std::vector<PeakBoundary> > boundaries_per_scan(input.size());
+    std::vector<char> was_picked(input.size(), 0);
+    bool centroid_input_error = false;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)input.size(); ++i)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      const Size scan_idx = (Size)i;
+      IF_MASTERTHREAD setProgress(progress);
+
+      // auto mode
+      if (ms_levels_.empty()) 
       {
-        bool was_picked{false};
-        // auto mode
-        if (ms_levels_.empty()) 
+        SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+        if (spectrum_type == SpectrumSettings::CENTROID)
         {
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
-          }
+          output[scan_idx] = input[scan_idx];
         }
-        // manual mode
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
+        else
         {
-          output[scan_idx] = input[scan_idx];
+          pick(input[scan_idx], output[scan_idx], boundaries_per_scan[scan_idx]);
+          was_picked[scan_idx] = 1;
+        }
+      }
+      // manual mode
+      else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
+      {
+        output[scan_idx] = input[scan_idx];
+      }
+      else
+      {
+        SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+        if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+        {
+          // cannot throw inside the parallel region, report after the loop
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+          centroid_input_error = true;
         }
         else
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
-          {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-          }
-
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
+          pick(input[scan_idx], output[scan_idx], boundaries_per_scan[scan_idx]);
+          was_picked[scan_idx] = 1;
         }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
       }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
     }
 
+    if (centroid_input_error)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      if (was_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(boundaries_per_scan[scan_idx]));
+      }
+      pick_info[input[scan_idx].getMSLevel()].picked += was_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
+    }
+
+    std::vector<MSChromatogram> chromatograms(input.getChromatograms().size());
+    std::vector<std::vector<PeakBoundary> > boundaries_per_chrom(input.getChromatograms().size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)input.getChromatograms().size(); ++i)
+    {
+      IF_MASTERTHREAD setProgress(progress);
+      pick(input.getChromatograms()[i], chromatograms[i], boundaries_per_chrom[i]);
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+    }
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      output.addChromatogram(std::move(chromatograms[i]));
+      boundaries_chrom.push_back(std::move(boundaries_per_chrom[i]));
     }
     endProgress();
 
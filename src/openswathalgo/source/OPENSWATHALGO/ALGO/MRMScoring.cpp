@@ -44,6 +44,51 @@
 namespace OpenSwath
 {
 
+  namespace
+  {
+    /// Copy the traces and standardize each of them once (instead of once per pair)
+    std::vector< std::vector<double> > standardizeTraces_(const std::vector< std::vector<double> >& data)
+    {
+      std::vector< std::vector<double> > result(data);
+      for (std::vector<double>& trace : result)
+      {
+        Scoring::standardize_data(trace);
+      }
+      return result;
+    }
+
+    /// Fetch the intensities of the given fragment (or precursor) features and standardize each trace once
+    std::vector< std::vector<double> > getStandardizedTraces_(OpenSwath::IMRMFeature* mrmfeature,
+                                                              const std::vector<std::string>& ids, bool precursor)
+    {
+      std::vector< std::vector<double> > result(ids.size());
+      for (std::size_t i = 0; i < ids.size(); i++)
+      {
+        MRMScoring::FeatureType f = precursor ? mrmfeature->getPrecursorFeature(ids[i]) : mrmfeature->getFeature(ids[i]);
+        f->getIntensity(result[i]);
+        Scoring::standardize_data(result[i]);
+      }
+      return result;
+    }
+
+    /// Cross-correlation of all pairs of standardized traces (only j >= i if symmetric)
+    void fillXCorrMatrix_(MRMScoring::XCorrMatrixType& xcorr_matrix,
+                          const std::vector< std::vector<double> >& traces1,
+                          const std::vector< std::vector<double> >& traces2,
+                          bool symmetric)
+    {
+      xcorr_matrix.resize(traces1.size());
+      for (std::size_t i = 0; i < traces1.size(); i++)
+      {
+        xcorr_matrix[i].resize(traces2.size());
+        for (std::size_t j = (symmetric ? i : 0); j < traces2.size(); j++)
+        {
+          xcorr_matrix[i][j] = Scoring::normalizedCrossCorrelationPost(traces1[i], traces2[j], boost::numeric_cast<int>(traces1[i].size()), 1);
+        }
+      }
+    }
+  }
+
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
   {
     return xcorr_matrix_;
@@ -51,18 +96,8 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
   {
-    xcorr_matrix_.resize(data.size());
-    for (std::size_t i = 0; i < data.size(); i++)
-    {
-      xcorr_matrix_[i].resize(data.size());
-      for (std::size_t j = i; j < data.size(); j++)
-      {
-        // compute normalized cross correlation
-        std::vector< double > tmp1(data[i]);
-        std::vector< double > tmp2(data[j]);
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(data[i].size()), 1);
-      }
-    }
+    std::vector< std::vector<double> > traces = standardizeTraces_(data);
+    fillXCorrMatrix_(xcorr_matrix_, traces, traces, true);
   }
 
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrContrastMatrix() const
@@ -82,149 +117,53 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector< std::vector<double> > traces = getStandardizedTraces_(mrmfeature, native_ids, false);
+    fillXCorrMatrix_(xcorr_matrix_, traces, traces, true);
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector< std::vector<double> > traces1 = getStandardizedTraces_(mrmfeature, native_ids_set1, false);
+    std::vector< std::vector<double> > traces2 = getStandardizedTraces_(mrmfeature, native_ids_set2, false);
+    fillXCorrMatrix_(xcorr_contrast_matrix_, traces1, traces2, false);
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector< std::vector<double> > traces = getStandardizedTraces_(mrmfeature, precursor_ids, true);
+    fillXCorrMatrix_(xcorr_precursor_matrix_, traces, traces, true);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector< std::vector<double> > traces1 = getStandardizedTraces_(mrmfeature, precursor_ids, true);
+    std::vector< std::vector<double> > traces2 = getStandardizedTraces_(mrmfeature, native_ids, false);
+    fillXCorrMatrix_(xcorr_precursor_contrast_matrix_, traces1, traces2, false);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(const std::vector< std::vector< double > >& data_precursor, const std::vector< std::vector< double > >& data_fragments)
   {
-    xcorr_precursor_contrast_matrix_.resize(data_precursor.size());
-    for (std::size_t i = 0; i < data_precursor.size(); i++)
-    { 
-      xcorr_precursor_contrast_matrix_[i].resize(data_fragments.size());
-      for (std::size_t j = 0; j < data_fragments.size(); j++)
-      {
-        // compute normalized cross correlation
-        std::vector< double > tmp1(data_precursor[i]);
-        std::vector< double > tmp2(data_fragments[j]);
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(tmp1.size()), 1);
+    std::vector< std::vector<double> > traces1 = standardizeTraces_(data_precursor);
+    std::vector< std::vector<double> > traces2 = standardizeTraces_(data_fragments);
+    fillXCorrMatrix_(xcorr_precursor_contrast_matrix_, traces1, traces2, false);
 #ifdef MRMSCORING_TESTING
-        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< tmp1.size() << " / " << tmp2.size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
-#endif
+    for (std::size_t i = 0; i < xcorr_precursor_contrast_matrix_.size(); i++)
+    {
+      for (std::size_t j = 0; j < xcorr_precursor_contrast_matrix_[i].size(); j++)
+      {
+        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< traces1[i].size() << " / " << traces2[j].size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
       }
     }
+#endif
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    // precursor traces first, then fragment traces
+    std::vector< std::vector<double> > traces = getStandardizedTraces_(mrmfeature, precursor_ids, true);
+    std::vector< std::vector<double> > fragment_traces = getStandardizedTraces_(mrmfeature, native_ids, false);
+    traces.insert(traces.end(), fragment_traces.begin(), fragment_traces.end());
+    fillXCorrMatrix_(xcorr_precursor_combined_matrix_, traces, traces, false);
   }
 
   // see /IMSB/users/reiterl/bin/code/biognosys/trunk/libs/mrm_libs/MRM_pgroup.pm
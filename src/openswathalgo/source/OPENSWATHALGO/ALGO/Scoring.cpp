@@ -164,10 +164,18 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
-      XCorrArrayType result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
+      return normalizedCrossCorrelationPost(data1, data2, maxdelay, lag);
+    }
+
+    XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                  const std::vector<double>& normalized_data2, const int& maxdelay, const int& lag)
+    {
+      OPENSWATH_PRECONDITION(normalized_data1.size() != 0 && normalized_data1.size() == normalized_data2.size(), "Both data vectors need to have the same length");
+
+      XCorrArrayType result = calculateCrossCorrelation(normalized_data1, normalized_data2, maxdelay, lag);
       for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
-        it->second = it->second / data1.size();
+        it->second = it->second / normalized_data1.size();
       }
       return result;
     }
@@ -180,19 +188,20 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      // data() (not &data1[0]) stays valid for empty traces, the precondition above is not checked in release builds
+      const double* x = data1.data();
+      const double* y = data2.data();
 
-      for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
+      for (int delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only sum over the overlap of both arrays (i and i + delay in range)
+        // instead of checking every index, the loop then has no branches
+        const int i_start = std::max(0, -delay);
+        const int i_end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (int i = i_start; i < i_end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += x[i] * y[i + delay];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
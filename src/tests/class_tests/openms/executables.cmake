@@ -264,6 +264,7 @@ set(format_executables_list
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
+  MSDataParallelTransformingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
   SpectrumAccessQuadMZTransforming_test
@@ -428,6 +429,7 @@ set(chemistry_executables_list
   SvmTheoreticalSpectrumGeneratorTrainer_test
   SvmTheoreticalSpectrumGenerator_test
   Tagger_test
+  TheoreticalSpectrumCache_test
   TheoreticalSpectrumGeneratorXLMS_test
   TheoreticalSpectrumGenerator_test
   WeightWrapper_test
@@ -661,6 +663,8 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathHelper_test
     OpenSwathScoring_test
     OpenSwathScores_test
+    OpenSwathOSWWriter_test
+    OpenSwathWorkflow_test
     PeakIntegrator_test
     PeakPickerMRM_test
     MRMTransitionGroupPicker_test
@@ -669,8 +673,10 @@ if(NOT DISABLE_OPENSWATH)
     DIAPrescoring_test
     OpenSwathMRMFeatureAccessOpenMS_test
     SpectrumAddition_test
+    SummedSpectrumCache_test
     TargetedSpectraExtractor_test
     OpenSwathSpectrumAccessOpenMS_test
+    SpectrumAccessOpenMSInMemory_test
     OpenSwathDataAccessHelper_test
     MasstraceCorrelator_test
     MRMBatchFeatureSelector_test
@@ -699,6 +705,7 @@ set(Boost_dependent_tests
   OpenSwathHelper_test
   OpenSwathMRMFeatureAccessOpenMS_test
   OpenSwathSpectrumAccessOpenMS_test
+  SpectrumAccessOpenMSInMemory_test
   PeakPickerMRM_test
   StatisticFunctions_test
   String_test
@@ -343,6 +343,13 @@ START_SECTION((void run(FeatureMap&, MzTab&) const))
     NEW_TMP_FILE(tmp_mztab_file2);
     MzTabFile().store(tmp_mztab_file2, test_mztab2);
     TEST_EQUAL(fsc.compareFiles(tmp_mztab_file2, OPENMS_GET_TEST_DATA_PATH("AccurateMassSearchEngine_output2_featureXML.mzTab")), true);
+
+    // an unparsable adduct is reported (the features are queried in parallel)
+    FeatureMap exp_fm3;
+    FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("AccurateMassSearchEngine_input1.featureXML"), exp_fm3);
+    exp_fm3[exp_fm3.size() - 1].setMetaValue("dc_charge_adducts", "Xy2");
+    MzTab test_mztab3;
+    TEST_EXCEPTION(Exception::ParseError, ams_feat_test2.run(exp_fm3, test_mztab3))
   }
 }
 END_SECTION
@@ -136,6 +136,64 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION([EXTRA RT range] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
+{
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+
+  // the same transition, once over the whole run and once restricted to an RT range
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 618.31; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr2";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 3050.0; coord.rt_end = 3130.0; coord.id = "tr2_rt";
+    coordinates.push_back(coord);
+    coord.mz = 654.38; coord.rt_start = 5000.0; coord.rt_end = 6000.0; coord.id = "tr3_outside";
+    coordinates.push_back(coord);
+  }
+  for (Size i = 0; i < coordinates.size(); i++)
+  {
+    OpenSwath::ChromatogramPtr s(new OpenSwath::Chromatogram);
+    out_exp.push_back(s);
+  }
+  extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat");
+
+  TEST_EQUAL(out_exp[0]->getTimeArray()->data.size(), 59);
+  TEST_EQUAL(out_exp[1]->getTimeArray()->data.size(), 59);
+  TEST_EQUAL(out_exp[3]->getTimeArray()->data.size(), 0);
+
+  // the restricted chromatogram is exactly the matching part of the full one
+  const std::vector<double>& full_rt = out_exp[1]->getTimeArray()->data;
+  const std::vector<double>& full_int = out_exp[1]->getIntensityArray()->data;
+  std::vector<double> expected_rt, expected_int;
+  for (Size i = 0; i < full_rt.size(); i++)
+  {
+    if (full_rt[i] >= 3050.0 && full_rt[i] <= 3130.0)
+    {
+      expected_rt.push_back(full_rt[i]);
+      expected_int.push_back(full_int[i]);
+    }
+  }
+  TEST_EQUAL(expected_rt.empty(), false)
+  TEST_EQUAL(out_exp[2]->getTimeArray()->data.size(), expected_rt.size())
+  TEST_EQUAL(out_exp[2]->getTimeArray()->data == expected_rt, true)
+  TEST_EQUAL(out_exp[2]->getIntensityArray()->data == expected_int, true)
+
+  double max_value = -1; double foundat = -1;
+  find_max_helper(out_exp[2], max_value, foundat);
+  TEST_REAL_SIMILAR(max_value, 169.792);
+  TEST_REAL_SIMILAR(foundat, 3120.26);
+}
+END_SECTION
+
 START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
 {
   typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
@@ -122,6 +122,25 @@ START_SECTION(testIntegrateWindows_test)
   TEST_REAL_SIMILAR (intInt[0], 2)
   TEST_REAL_SIMILAR (intMz[0], 100.5);
 
+  // windows in arbitrary order, same result as integrateWindow
+  std::vector<std::pair<double, double> > mz_windows;
+  mz_windows.push_back(std::make_pair(104.5, 106.5));
+  mz_windows.push_back(std::make_pair(101., 103.));
+  mz_windows.push_back(std::make_pair(200., 201.));
+  mz_windows.push_back(std::make_pair(99., 101.5));
+  std::vector<double> win_mz, win_int;
+  DIAHelpers::integrateWindows(spec, mz_windows, win_mz, win_int);
+  TEST_EQUAL (win_mz.size(), 4)
+  TEST_EQUAL (win_int.size(), 4)
+  TEST_REAL_SIMILAR (win_mz[0], 105.5)
+  TEST_REAL_SIMILAR (win_int[0], 2)
+  TEST_REAL_SIMILAR (win_mz[1], 101.5)
+  TEST_REAL_SIMILAR (win_int[1], 2)
+  TEST_REAL_SIMILAR (win_mz[2], -1)
+  TEST_REAL_SIMILAR (win_int[2], 0)
+  TEST_REAL_SIMILAR (win_mz[3], 100.5)
+  TEST_REAL_SIMILAR (win_int[3], 2)
+
   // std::cout << "print Int" << std::endl;
   // std::copy(intInt.begin(), intInt.end(),
   //     std::ostream_iterator<double>(std::cout, " "));
@@ -38,6 +38,13 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderIdentificationAlgorithm.h>
 ///////////////////////////
 
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -61,6 +68,70 @@ START_SECTION(~FeatureFinderIdentificationAlgorithm())
 }
 END_SECTION
 
+START_SECTION((void run(std::vector<PeptideIdentification> peptides, const std::vector<ProteinIdentification>& proteins, std::vector<PeptideIdentification> peptides_ext, std::vector<ProteinIdentification> proteins_ext, FeatureMap& features, const FeatureMap& seeds = FeatureMap())))
+{
+  // chunks are extracted and scored in parallel: the result must not depend on the number of threads
+  String in = OPENMS_GET_TEST_DATA_PATH("../../../topp/FeatureFinderIdentification_1_input.mzML");
+  vector<PeptideIdentification> peptides;
+  vector<ProteinIdentification> proteins;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("../../../topp/FeatureFinderIdentification_1_input.idXML"), proteins, peptides);
+
+  Param params = FeatureFinderIdentificationAlgorithm().getDefaults();
+  params.setValue("extract:mz_window", 0.1);
+  params.setValue("extract:batch_size", 5); // several chunks
+  params.setValue("detect:peak_width", 60.0);
+  params.setValue("model:type", "none");
+
+  int max_threads = 1;
+#ifdef _OPENMP
+  max_threads = omp_get_max_threads();
+#endif
+  std::vector<int> thread_counts = {1, std::max(max_threads, 4)};
+  std::vector<FeatureMap> results;
+  std::vector<Size> nr_chromatograms;
+  for (int threads : thread_counts)
+  {
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    FeatureFinderIdentificationAlgorithm ffid;
+    ffid.getProgressLogger().setLogType(ProgressLogger::NONE);
+    ffid.setParameters(params);
+    ffid.setKeepChromatograms(true);
+    MzMLFile mzml;
+    mzml.getOptions().addMSLevel(1);
+    mzml.load(in, ffid.getMSData());
+
+    FeatureMap features;
+    features.setPrimaryMSRunPath({in}, ffid.getMSData());
+    ffid.run(peptides, proteins, vector<PeptideIdentification>(), vector<ProteinIdentification>(), features);
+    results.push_back(features);
+    nr_chromatograms.push_back(ffid.getChromatograms().getNrChromatograms());
+  }
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  TEST_NOT_EQUAL(results[0].size(), 0)
+  TEST_NOT_EQUAL(nr_chromatograms[0], 0)
+  TEST_EQUAL(nr_chromatograms[1], nr_chromatograms[0])
+  TEST_EQUAL(results[1].size(), results[0].size())
+  ABORT_IF(results[1].size() != results[0].size())
+  set<UInt64> unique_ids;
+  for (Size i = 0; i < results[0].size(); ++i)
+  {
+    TEST_REAL_SIMILAR(results[1][i].getRT(), results[0][i].getRT())
+    TEST_REAL_SIMILAR(results[1][i].getMZ(), results[0][i].getMZ())
+    TEST_REAL_SIMILAR(results[1][i].getIntensity(), results[0][i].getIntensity())
+    TEST_EQUAL(results[1][i].getCharge(), results[0][i].getCharge())
+    TEST_EQUAL(results[1][i].getMetaValue("PeptideRef"), results[0][i].getMetaValue("PeptideRef"))
+    unique_ids.insert(results[1][i].getUniqueId());
+  }
+  // unique ids are reassigned after the parallel chunks, they must not collide
+  TEST_EQUAL(unique_ids.size(), results[1].size())
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
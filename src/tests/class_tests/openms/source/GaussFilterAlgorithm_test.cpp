@@ -96,6 +96,40 @@ START_SECTION((template <typename ConstIterT, typename IterT> bool filter(ConstI
   TEST_REAL_SIMILAR(*it,1.0)
   ++it;
   TEST_REAL_SIMILAR(*it,1.0)
+
+  // equidistant data is convoluted with precomputed weights, the result has to
+  // match the general path (taken for slightly non-equidistant data)
+  std::vector<double> mz_uniform, mz_jitter, peak;
+  for (Size i = 0; i < 200; ++i)
+  {
+    mz_uniform.push_back(500.0 + 0.007 * i);
+    mz_jitter.push_back(500.0 + 0.007 * i + ((i % 2) ? 1e-7 : 0.0));
+    peak.push_back(1000.0 * exp(-0.5 * pow((i - 100.0) / 8.0, 2)) + (i % 7));
+  }
+  std::vector<double> mz_out_uniform(200), int_out_uniform(200), mz_out_jitter(200), int_out_jitter(200);
+  gauss.initialize(0.1, 0.01, 10.0, false);
+  gauss.filter(mz_uniform.begin(), mz_uniform.end(), peak.begin(), mz_out_uniform.begin(), int_out_uniform.begin());
+  gauss.filter(mz_jitter.begin(), mz_jitter.end(), peak.begin(), mz_out_jitter.begin(), int_out_jitter.begin());
+  TOLERANCE_RELATIVE(1.0001)
+  for (Size i = 0; i < 200; ++i)
+  {
+    TEST_REAL_SIMILAR(mz_out_uniform[i], mz_uniform[i])
+    TEST_REAL_SIMILAR(int_out_uniform[i], int_out_jitter[i])
+  }
+  TOLERANCE_RELATIVE(1.00001)
+
+  // ppm tolerance: the kernel width grows with m/z, a constant signal stays constant
+  std::vector<double> mz_ppm, flat(200, 5.0), mz_out_ppm(200), int_out_ppm(200);
+  for (Size i = 0; i < 200; ++i)
+  {
+    mz_ppm.push_back(500.0 + 0.01 * i + 1e-5 * i * i);
+  }
+  gauss.initialize(0.1, 0.01, 10.0, true);
+  gauss.filter(mz_ppm.begin(), mz_ppm.end(), flat.begin(), mz_out_ppm.begin(), int_out_ppm.begin());
+  for (Size i = 1; i < 199; ++i)
+  {
+    TEST_REAL_SIMILAR(int_out_ppm[i], 5.0)
+  }
 END_SECTION 
 
 START_SECTION((bool filter(OpenMS::Interfaces::SpectrumPtr spectrum)))
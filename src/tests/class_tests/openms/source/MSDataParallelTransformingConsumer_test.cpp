@@ -0,0 +1,202 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelTransformingConsumer* parallel_consumer_ptr = nullptr;
+MSDataParallelTransformingConsumer* parallel_consumer_nullPointer = nullptr;
+
+PeakMap expc;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), expc);
+
+auto f_spec = [](MSSpectrum& s)
+{
+  s.sortByIntensity();
+};
+auto f_chrom = [](MSChromatogram& c)
+{
+  c.sortByIntensity();
+};
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0)))
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(parallel_consumer_ptr, parallel_consumer_nullPointer)
+  TEST_EQUAL(parallel_consumer_ptr->getBatchSize() > 0, true)
+  delete parallel_consumer_ptr;
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // remaining data is passed on when the consumer is destroyed
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer, 10);
+  parallel_consumer_ptr->consumeSpectrum(expc.getSpectrum(0));
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+  delete parallel_consumer_ptr;
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+}
+END_SECTION
+
+START_SECTION((Size getBatchSize() const))
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 3);
+  TEST_EQUAL(parallel_consumer.getBatchSize(), 3)
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType & s)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 3);
+  parallel_consumer.setSpectraProcessingFunc(f_spec);
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrSpectra(), 4)
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  // the input is not modified, only the first (full) batch is passed on yet
+  TEST_EQUAL(exp == expc, true)
+  TEST_EQUAL(storing_consumer.getData().size(), 3)
+
+  parallel_consumer.flush();
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), 4)
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    MSSpectrum expected = expc.getSpectrum(i);
+    f_spec(expected);
+    TEST_EQUAL(result[i] == expected, true)
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType & c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 3);
+  parallel_consumer.setChromatogramProcessingFunc(f_chrom);
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrChromatograms(), 2)
+  // spectra and chromatograms keep their relative order
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(0));
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 0)
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(1));
+  parallel_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0] == expc.getSpectrum(0), true) // no spectrum function set
+  TEST_EQUAL(result.getNrChromatograms(), 2)
+  for (Size i = 0; i < result.getNrChromatograms(); ++i)
+  {
+    MSChromatogram expected = expc.getChromatogram(i);
+    f_chrom(expected);
+    TEST_EQUAL(result.getChromatograms()[i] == expected, true)
+  }
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // data consumed before a failing spectrum is passed on, the error is rethrown
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 10);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+  {
+    if (s.getNativeID() == "index=2")
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "cannot process spectrum", s.getNativeID());
+    }
+  });
+
+  PeakMap exp = expc;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  TEST_EXCEPTION(Exception::InvalidValue, parallel_consumer.flush())
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+
+  // the failed batch is discarded
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 2)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+  NOT_TESTABLE // passed on to the downstream consumer
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const OpenMS::ExperimentalSettings& es)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+  bool called = false;
+  parallel_consumer.setExperimentalSettingsFunc([&called](const ExperimentalSettings&) { called = true; });
+
+  ExperimentalSettings settings;
+  settings.setComment("parallel");
+  parallel_consumer.setExperimentalSettings(settings);
+  TEST_EQUAL(called, true)
+  TEST_EQUAL(storing_consumer.getData().getComment(), "parallel")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
@@ -0,0 +1,173 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/SqliteConnector.h>
+
+#include <sqlite3.h>
+
+using namespace OpenMS;
+using namespace std;
+
+FeatureMap createFeatures()
+{
+  FeatureMap output;
+  Feature f;
+  f.setUniqueId(42);
+  f.setRT(1234.5678901);
+  f.setIntensity(100.0);
+  f.setMetaValue("leftWidth", 1200.0);
+  f.setMetaValue("rightWidth", 1260.0);
+  f.setMetaValue("var_xcorr_shape", 0.9);
+  f.setMetaValue("var_library_corr", std::numeric_limits<double>::quiet_NaN());
+
+  Feature sub;
+  sub.setMetaValue("FeatureLevel", "MS2");
+  sub.setMetaValue("native_id", "7");
+  sub.setIntensity(50.0);
+  sub.setMetaValue("total_xic", 500.0);
+  sub.setMetaValue("peak_apex_int", 10.0);
+  f.getSubordinates().push_back(sub);
+  sub.setMetaValue("native_id", "8");
+  f.getSubordinates().push_back(sub);
+
+  output.push_back(f);
+  return output;
+}
+
+Size countRows(sqlite3* db, const String& sql)
+{
+  sqlite3_stmt* stmt;
+  SqliteConnector::prepareStatement(db, &stmt, sql);
+  sqlite3_step(stmt);
+  Size count = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  return count;
+}
+
+START_TEST(OpenSwathOSWWriter, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathOSWWriter* ptr = nullptr;
+OpenSwathOSWWriter* nullPointer = nullptr;
+
+START_SECTION(OpenSwathOSWWriter(const String& output_filename, const UInt64 run_id, const String& input_filename = "inputfile", bool ms1_scores = false, bool sonar = false, bool uis_scores = false))
+{
+  ptr = new OpenSwathOSWWriter("", 1);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isActive(), false)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(String prepareLine(const OpenSwath::LightCompound&, const OpenSwath::LightTransition*, const FeatureMap& output, const String& id) const)
+{
+  OpenSwathOSWWriter writer("dummy.osw", 1);
+  String line = writer.prepareLine(OpenSwath::LightCompound(), nullptr, createFeatures(), "3");
+
+  TEST_EQUAL(line.hasPrefix("INSERT INTO FEATURE (ID, RUN_ID, PRECURSOR_ID, EXP_RT"), true)
+  TEST_EQUAL(line.hasSubstring("VALUES (42, 1, 3, "), true)
+  TEST_EQUAL(line.hasSubstring("INSERT INTO FEATURE_MS2 "), true)
+  TEST_EQUAL(line.hasSubstring("INSERT INTO FEATURE_MS1 "), false)
+  TEST_EQUAL(line.hasSubstring("INSERT INTO FEATURE_TRANSITION (FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI) VALUES (42, 7, 50"), true)
+  TEST_EQUAL(line.hasSubstring("nan"), false)
+}
+END_SECTION
+
+START_SECTION(void prepareRows(const FeatureMap& output, const String& id, OSWRows& rows) const)
+{
+  OpenSwathOSWWriter writer("dummy.osw", 1, "inputfile", true);
+  OpenSwathOSWWriter::OSWRows rows;
+  TEST_EQUAL(rows.empty(), true)
+
+  writer.prepareRows(createFeatures(), "3", rows);
+  TEST_EQUAL(rows.empty(), false)
+  TEST_EQUAL(rows.feature.size(), 9)
+  TEST_EQUAL(rows.feature_ms1.size(), 16)
+  TEST_EQUAL(rows.feature_ms2.size(), 39)
+  TEST_EQUAL(rows.feature_transition.size(), 2 * 6)
+  TEST_EQUAL(rows.feature_transition_uis.size(), 0)
+
+  TEST_EQUAL(rows.feature[0].type, OpenSwathOSWWriter::OSWRows::Value::INT_VALUE)
+  TEST_EQUAL(rows.feature[0].int_value, 42)
+  TEST_EQUAL(rows.feature[3].type, OpenSwathOSWWriter::OSWRows::Value::REAL_VALUE)
+  TEST_REAL_SIMILAR(rows.feature[3].real_value, 1234.5678901)
+  TEST_EQUAL(rows.feature[4].type, OpenSwathOSWWriter::OSWRows::Value::NULL_VALUE) // no ion mobility
+
+  // append a second group
+  OpenSwathOSWWriter::OSWRows more;
+  writer.prepareRows(createFeatures(), "4", more);
+  rows.append(more);
+  TEST_EQUAL(rows.feature.size(), 2 * 9)
+  TEST_EQUAL(rows.feature[9 + 2].type, OpenSwathOSWWriter::OSWRows::Value::TEXT_VALUE)
+  TEST_EQUAL(rows.texts[rows.feature[9 + 2].int_value], "4")
+
+  rows.clear();
+  TEST_EQUAL(rows.empty(), true)
+  TEST_EQUAL(rows.texts.empty(), true)
+}
+END_SECTION
+
+START_SECTION(void writeRows(const OSWRows& rows))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  OpenSwathOSWWriter writer(filename, 1);
+  writer.writeHeader();
+
+  OpenSwathOSWWriter::OSWRows rows;
+  writer.prepareRows(createFeatures(), "3", rows);
+  writer.writeRows(rows);
+
+  SqliteConnector conn(filename);
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE"), 1)
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE_MS2"), 1)
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE_TRANSITION"), 2)
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE WHERE PRECURSOR_ID = 3"), 1)
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE_TRANSITION WHERE TRANSITION_ID = 8 AND TOTAL_MI IS NULL"), 1)
+  TEST_EQUAL(countRows(conn.getDB(), "SELECT COUNT(*) FROM FEATURE_MS2 WHERE VAR_LIBRARY_CORR IS NULL AND VAR_XCORR_SHAPE = 0.9"), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <boost/shared_ptr.hpp>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  OpenSwath::LightTransition makeTransition(const String& id, const String& peptide, double precursor_mz, double product_mz)
+  {
+    OpenSwath::LightTransition tr;
+    tr.transition_name = id;
+    tr.peptide_ref = peptide;
+    tr.library_intensity = 100.0;
+    tr.precursor_mz = precursor_mz;
+    tr.product_mz = product_mz;
+    tr.decoy = false;
+    tr.detecting_transition = true;
+    tr.quantifying_transition = true;
+    tr.identifying_transition = false;
+    return tr;
+  }
+
+  OpenSwath::LightCompound makeCompound(const String& id, double rt)
+  {
+    OpenSwath::LightCompound c;
+    c.id = id;
+    c.rt = rt;
+    c.charge = 2;
+    c.sequence = "PEPTIDE";
+    return c;
+  }
+
+  // three SWATH windows (400-425, 425-450, 450-475) acquired in cycles of one MS1 and three MS2 spectra
+  PeakMap makeSwathRun()
+  {
+    PeakMap run;
+    for (Size cycle = 0; cycle < 10; ++cycle)
+    {
+      MSSpectrum ms1;
+      ms1.setMSLevel(1);
+      ms1.setRT(10.0 * cycle);
+      ms1.push_back(Peak1D(410.0, 1000.0));
+      run.addSpectrum(ms1);
+
+      for (Size w = 0; w < 3; ++w)
+      {
+        MSSpectrum ms2;
+        ms2.setMSLevel(2);
+        ms2.setRT(10.0 * cycle + 1.0 + w);
+        Precursor prec;
+        prec.setMZ(412.5 + 25.0 * w);
+        prec.setIsolationWindowLowerOffset(12.5);
+        prec.setIsolationWindowUpperOffset(12.5);
+        ms2.getPrecursors().push_back(prec);
+        ms2.push_back(Peak1D(499.99, 10.0 + cycle));
+        ms2.push_back(Peak1D(500.02, 1.0));
+        ms2.push_back(Peak1D(600.0, 5.0 * cycle));
+        ms2.push_back(Peak1D(700.0, 100.0 - cycle));
+        ms2.push_back(Peak1D(900.0, 7.0));
+        run.addSpectrum(ms2);
+      }
+    }
+    return run;
+  }
+
+  bool compareNativeID(const MSChromatogram& a, const MSChromatogram& b)
+  {
+    return a.getNativeID() < b.getNativeID();
+  }
+}
+
+START_TEST(OpenSwathCalibrationWorkflow, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathCalibrationWorkflow* ptr = nullptr;
+OpenSwathCalibrationWorkflow* nullPointer = nullptr;
+
+START_SECTION(OpenSwathCalibrationWorkflow())
+{
+  ptr = new OpenSwathCalibrationWorkflow();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION(virtual ~OpenSwathCalibrationWorkflow())
+{
+  delete ptr;
+}
+END_SECTION
+
+// iRT assay library: two transitions of peptide A (window 400-425), two of
+// peptide B (window 425-450), one of which has no signal
+OpenSwath::LightTargetedExperiment irt_transitions;
+irt_transitions.transitions.push_back(makeTransition("tr_A1", "pep_A", 410.0, 500.0));
+irt_transitions.transitions.push_back(makeTransition("tr_A2", "pep_A", 410.0, 600.0));
+irt_transitions.transitions.push_back(makeTransition("tr_B1", "pep_B", 440.0, 700.0));
+irt_transitions.transitions.push_back(makeTransition("tr_B2", "pep_B", 440.0, 800.0));
+irt_transitions.compounds.push_back(makeCompound("pep_A", 30.0));
+irt_transitions.compounds.push_back(makeCompound("pep_B", 60.0));
+
+ChromExtractParams cp;
+cp.min_upper_edge_dist = 0.0;
+cp.mz_extraction_window = 0.05;
+cp.ppm = false;
+cp.im_extraction_window = -1;
+cp.extraction_function = "tophat";
+cp.rt_extraction_window = 40.0;
+cp.extra_rt_extract = 0.0;
+
+PeakMap run = makeSwathRun();
+
+START_SECTION((std::function<void (const OpenMS::MSSpectrum&)> getStreamingExtractionFunc(const OpenSwath::LightTargetedExperiment & irt_transitions, const ChromExtractParams & cp)))
+{
+  OpenSwathCalibrationWorkflow wf;
+  std::function<void (const OpenMS::MSSpectrum&)> f = wf.getStreamingExtractionFunc(irt_transitions, cp);
+  for (Size i = 0; i < run.size(); ++i)
+  {
+    f(run[i]);
+  }
+  std::vector< OpenMS::MSChromatogram > chromatograms;
+  wf.retrieveStreamingChromatograms(chromatograms);
+  TEST_EQUAL(chromatograms.size(), 3)
+
+  // ion mobility extraction and other extraction functions are not supported while streaming
+  ChromExtractParams cp_im = cp;
+  cp_im.im_extraction_window = 0.05;
+  TEST_EXCEPTION(Exception::NotImplemented, wf.getStreamingExtractionFunc(irt_transitions, cp_im))
+  ChromExtractParams cp_bartlett = cp;
+  cp_bartlett.extraction_function = "bartlett";
+  TEST_EXCEPTION(Exception::NotImplemented, wf.getStreamingExtractionFunc(irt_transitions, cp_bartlett))
+}
+END_SECTION
+
+START_SECTION(void retrieveStreamingChromatograms(std::vector< OpenMS::MSChromatogram > & chromatograms))
+{
+  // streamed extraction
+  OpenSwathCalibrationWorkflow wf;
+  std::function<void (const OpenMS::MSSpectrum&)> f = wf.getStreamingExtractionFunc(irt_transitions, cp);
+  for (Size i = 0; i < run.size(); ++i)
+  {
+    f(run[i]);
+  }
+  std::vector< OpenMS::MSChromatogram > streamed;
+  wf.retrieveStreamingChromatograms(streamed);
+
+  // extraction from the loaded SWATH maps
+  std::vector< OpenSwath::SwathMap > swath_maps;
+  for (Size w = 0; w < 3; ++w)
+  {
+    boost::shared_ptr<PeakMap> window_exp(new PeakMap);
+    for (Size i = 0; i < run.size(); ++i)
+    {
+      if (run[i].getMSLevel() == 2 && run[i].getPrecursors()[0].getMZ() == 412.5 + 25.0 * w)
+      {
+        window_exp->addSpectrum(run[i]);
+      }
+    }
+    OpenSwath::SwathMap m;
+    m.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(window_exp);
+    m.lower = 400.0 + 25.0 * w;
+    m.upper = 425.0 + 25.0 * w;
+    m.center = 412.5 + 25.0 * w;
+    m.ms1 = false;
+    swath_maps.push_back(m);
+  }
+  std::vector< OpenMS::MSChromatogram > extracted;
+  OpenSwathCalibrationWorkflow().simpleExtractChromatograms_(swath_maps, irt_transitions, extracted,
+                                                              TransformationDescription(), cp, false, false);
+
+  // the empty chromatogram (tr_B2) is dropped in both cases
+  TEST_EQUAL(streamed.size(), 3)
+  TEST_EQUAL(extracted.size(), 3)
+  std::sort(streamed.begin(), streamed.end(), compareNativeID);
+  std::sort(extracted.begin(), extracted.end(), compareNativeID);
+  for (Size k = 0; k < std::min(streamed.size(), extracted.size()); ++k)
+  {
+    TEST_EQUAL(streamed[k].getNativeID(), extracted[k].getNativeID())
+    TEST_REAL_SIMILAR(streamed[k].getPrecursor().getMZ(), extracted[k].getPrecursor().getMZ())
+    TEST_REAL_SIMILAR(streamed[k].getProduct().getMZ(), extracted[k].getProduct().getMZ())
+    TEST_EQUAL(streamed[k].size(), extracted[k].size())
+    for (Size p = 0; p < std::min(streamed[k].size(), extracted[k].size()); ++p)
+    {
+      TEST_REAL_SIMILAR(streamed[k][p].getRT(), extracted[k][p].getRT())
+      TEST_REAL_SIMILAR(streamed[k][p].getIntensity(), extracted[k][p].getIntensity())
+    }
+  }
+  TEST_EQUAL(streamed[0].getNativeID(), "tr_A1")
+  TEST_EQUAL(streamed[0].size(), 4) // RT 11 to 41 (library RT 30 +/- 20)
+  TEST_REAL_SIMILAR(streamed[0][0].getIntensity(), 11.0 + 1.0) // cycle 1: both peaks are within 0.025 Th of 500.0
+
+  // the internal state is reset
+  std::vector< OpenMS::MSChromatogram > again;
+  wf.retrieveStreamingChromatograms(again);
+  TEST_EQUAL(again.size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -91,6 +91,27 @@ START_SECTION((template < typename PeakType > void filter(MSSpectrum &spectrum))
   TEST_REAL_SIMILAR(it->getIntensity(),0.0)
   ++it;
   TEST_REAL_SIMILAR(it->getIntensity(),0.0)
+
+  // the blocked convolution has to reproduce the iterator based filter
+  MSSpectrum long_spectrum;
+  for (Size i = 0; i < 3000; ++i)
+  {
+    long_spectrum.push_back(Peak1D(400.0 + 0.01 * i, 100.0f + (i % 13) * 7.0f + (i % 5 == 0 ? 300.0f : 0.0f)));
+  }
+  Param param_long;
+  param_long.setValue("polynomial_order", 4);
+  param_long.setValue("frame_length", 11);
+  SavitzkyGolayFilter sgolay_long;
+  sgolay_long.setParameters(param_long);
+  MSSpectrum reference = long_spectrum;
+  sgolay_long.filter(long_spectrum.begin(), long_spectrum.end(), reference.begin());
+  sgolay_long.filter(long_spectrum);
+  ABORT_IF(long_spectrum.size() != reference.size())
+  for (Size i = 0; i < long_spectrum.size(); ++i)
+  {
+    TEST_EQUAL(long_spectrum[i].getIntensity(), reference[i].getIntensity())
+    TEST_EQUAL(long_spectrum[i].getMZ(), reference[i].getMZ())
+  }
 END_SECTION 
 
 
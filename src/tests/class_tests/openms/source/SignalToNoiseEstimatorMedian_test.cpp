@@ -114,6 +114,43 @@ START_SECTION([EXTRA](virtual void init(const Container& c)))
 
 END_SECTION
 
+START_SECTION([EXTRA](exact median of the sliding window))
+
+  MSSpectrum raw_data;
+  DTAFile dta_file;
+  dta_file.load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  p.setValue("median_method", "exact");
+  sne.setParameters(p);
+  sne.init(raw_data);
+
+  // compare to the median of each window computed from scratch
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    std::vector<double> window;
+    for (Size j = 0; j < raw_data.size(); ++j)
+    {
+      if (raw_data[j].getMZ() >= raw_data[i].getMZ() - 20.0 && raw_data[j].getMZ() <= raw_data[i].getMZ() + 20.0)
+      {
+        window.push_back(raw_data[j].getIntensity());
+      }
+    }
+    double noise = 2.0;
+    if (window.size() >= 10)
+    {
+      std::sort(window.begin(), window.end());
+      noise = std::max(1.0, window[(window.size() + 1) / 2 - 1]);
+    }
+    TEST_REAL_SIMILAR(sne.getSignalToNoise(i), raw_data[i].getIntensity() / noise)
+  }
+
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -0,0 +1,171 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// in-memory access to spectra at the given retention times
+boost::shared_ptr<SpectrumAccessOpenMSInMemory> getInMemoryAccess(const std::vector<double>& rts)
+{
+  boost::shared_ptr<PeakMap> exp(new PeakMap);
+  for (double rt : rts)
+  {
+    MSSpectrum s;
+    s.setRT(rt);
+    s.push_back(Peak1D(100.0, 1.0));
+    exp->addSpectrum(s);
+  }
+  SpectrumAccessOpenMS origin(exp);
+  return boost::shared_ptr<SpectrumAccessOpenMSInMemory>(new SpectrumAccessOpenMSInMemory(origin));
+}
+
+// reference implementation of getSpectraByRT() using a binary search
+std::vector<std::size_t> getSpectraByRTReference(const std::vector<double>& rts, double RT, double deltaRT)
+{
+  std::vector<std::size_t> result;
+  std::size_t idx = std::lower_bound(rts.begin(), rts.end(), RT - deltaRT) - rts.begin();
+  if (idx == rts.size()) return result;
+  result.push_back(idx);
+  for (++idx; idx < rts.size() && rts[idx] < RT + deltaRT; ++idx)
+  {
+    result.push_back(idx);
+  }
+  return result;
+}
+
+START_TEST(SpectrumAccessOpenMSInMemory, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectrumAccessOpenMSInMemory* ptr = nullptr;
+SpectrumAccessOpenMSInMemory* nullPointer = nullptr;
+
+START_SECTION(explicit SpectrumAccessOpenMSInMemory(OpenSwath::ISpectrumAccess & origin))
+{
+  boost::shared_ptr<PeakMap> exp(new PeakMap);
+  SpectrumAccessOpenMS origin(exp);
+  ptr = new SpectrumAccessOpenMSInMemory(origin);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNrSpectra(), 0)
+  TEST_EQUAL(ptr->getSpectraByRT(10.0, 1.0).empty(), true)
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessOpenMSInMemory())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  // RT range 0-4 with 4 spectra: the RT index uses buckets of width 1, i.e.
+  // bucket boundaries at 0, 1, 2, 3 and 4 (all but 3 fall onto a spectrum)
+  std::vector<double> rts = {0.0, 1.0, 2.0, 4.0};
+  boost::shared_ptr<SpectrumAccessOpenMSInMemory> sa = getInMemoryAccess(rts);
+  TEST_EQUAL(sa->getNrSpectra(), 4)
+
+  std::vector<std::size_t> result;
+
+  // before the first spectrum: the first spectrum is always returned
+  result = sa->getSpectraByRT(-5.0, 1.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 0)
+  result = sa->getSpectraByRT(-1.0, 1.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 0)
+
+  // after the last spectrum
+  TEST_EQUAL(sa->getSpectraByRT(10.0, 1.0).empty(), true)
+  TEST_EQUAL(sa->getSpectraByRT(4.5, 0.25).empty(), true)
+  result = sa->getSpectraByRT(4.0, 0.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 3)
+
+  // exactly on bucket boundaries
+  result = sa->getSpectraByRT(2.0, 0.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 2)
+  result = sa->getSpectraByRT(3.0, 0.0); // boundary without a spectrum
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 3)
+  result = sa->getSpectraByRT(2.0, 1.0);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 2)
+
+  // same result as a binary search everywhere, including close to the boundaries
+  std::vector<double> query_rts = {-1.0, 0.0, 1e-9, 0.5, 1.0 - 1e-9, 1.0, 1.0 + 1e-9, 2.5, 3.0, 3.999999, 4.0, 4.000001, 5.0};
+  for (double rt : query_rts)
+  {
+    for (double delta : {0.0, 0.25, 1.0})
+    {
+      std::vector<std::size_t> expected = getSpectraByRTReference(rts, rt, delta);
+      result = sa->getSpectraByRT(rt, delta);
+      TEST_EQUAL(result.size(), expected.size())
+      ABORT_IF(result.size() != expected.size())
+      for (Size k = 0; k < result.size(); ++k)
+      {
+        TEST_EQUAL(result[k], expected[k])
+      }
+    }
+  }
+
+  // a light clone uses the same index
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> clone = sa->lightClone();
+  result = clone->getSpectraByRT(3.0, 0.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 3)
+
+  // a single spectrum (no RT index is built)
+  boost::shared_ptr<SpectrumAccessOpenMSInMemory> single = getInMemoryAccess({5.0});
+  TEST_EQUAL(single->getSpectraByRT(1.0, 1.0).size(), 1)
+  TEST_EQUAL(single->getSpectraByRT(5.0, 0.0).size(), 1)
+  TEST_EQUAL(single->getSpectraByRT(6.0, 0.5).empty(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/SummedSpectrumCache.h>
+
+///////////////////////////
+
+START_TEST(SummedSpectrumCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+SummedSpectrumCache* ptr = nullptr;
+SummedSpectrumCache* nullPointer = nullptr;
+
+START_SECTION(SummedSpectrumCache(Size capacity = 256))
+  ptr = new SummedSpectrumCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getCapacity(), 256)
+  TEST_EQUAL(ptr->size(), 0)
+END_SECTION
+
+START_SECTION(virtual ~SummedSpectrumCache())
+  delete ptr;
+END_SECTION
+
+int computed = 0;
+auto make_spectrum = [&computed](double mz)
+{
+  return [&computed, mz]()
+  {
+    ++computed;
+    OpenSwath::SpectrumPtr s(new OpenSwath::Spectrum);
+    s->getMZArray()->data.push_back(mz);
+    s->getIntensityArray()->data.push_back(100.0);
+    return s;
+  };
+};
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrum(const Key& key, const std::function<OpenSwath::SpectrumPtr()>& compute))
+  SummedSpectrumCache cache(2);
+  SummedSpectrumCache::Key k1(nullptr, 10, 3, -1, -1, "simple", 0.0);
+  SummedSpectrumCache::Key k2(nullptr, 11, 3, -1, -1, "simple", 0.0);
+  SummedSpectrumCache::Key k3(nullptr, 10, 3, 0.5, 0.7, "simple", 0.0); // same scan, different ion mobility window
+  SummedSpectrumCache::Key k4(nullptr, 10, 3, -1, -1, "resample", 0.005); // same scan and window, different addition method
+
+  OpenSwath::SpectrumPtr s1 = cache.getSpectrum(k1, make_spectrum(100.0));
+  TEST_EQUAL(computed, 1)
+  TEST_REAL_SIMILAR(s1->getMZArray()->data[0], 100.0)
+
+  // second request returns the same (shared) spectrum
+  OpenSwath::SpectrumPtr s1b = cache.getSpectrum(k1, make_spectrum(999.0));
+  TEST_EQUAL(computed, 1)
+  TEST_EQUAL(s1 == s1b, true)
+
+  OpenSwath::SpectrumPtr s2 = cache.getSpectrum(k2, make_spectrum(200.0));
+  TEST_EQUAL(computed, 2)
+  TEST_REAL_SIMILAR(s2->getMZArray()->data[0], 200.0)
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_EQUAL(cache.getMisses(), 2)
+
+  // k1 was used less recently than k2 and is evicted
+  OpenSwath::SpectrumPtr s3 = cache.getSpectrum(k3, make_spectrum(300.0));
+  TEST_EQUAL(computed, 3)
+  TEST_EQUAL(cache.size(), 2)
+  cache.getSpectrum(k2, make_spectrum(999.0));
+  TEST_EQUAL(computed, 3)
+  cache.getSpectrum(k1, make_spectrum(100.0));
+  TEST_EQUAL(computed, 4)
+
+  // evicted spectra stay valid
+  TEST_REAL_SIMILAR(s1->getMZArray()->data[0], 100.0)
+
+  // spectra added up with another method are not re-used
+  OpenSwath::SpectrumPtr s4 = cache.getSpectrum(k4, make_spectrum(400.0));
+  TEST_EQUAL(computed, 5)
+  TEST_REAL_SIMILAR(s4->getMZArray()->data[0], 400.0)
+END_SECTION
+
+START_SECTION(void setCapacity(Size capacity))
+  SummedSpectrumCache cache(5);
+  for (int i = 0; i < 5; ++i)
+  {
+    cache.getSpectrum(SummedSpectrumCache::Key(nullptr, i, 1, -1, -1, "simple", 0.0), make_spectrum(100.0 + i));
+  }
+  TEST_EQUAL(cache.size(), 5)
+  cache.setCapacity(2);
+  TEST_EQUAL(cache.getCapacity(), 2)
+  TEST_EQUAL(cache.size(), 2)
+  cache.setCapacity(0);
+  TEST_EQUAL(cache.size(), 0)
+  cache.getSpectrum(SummedSpectrumCache::Key(nullptr, 1, 1, -1, -1, "simple", 0.0), make_spectrum(101.0));
+  TEST_EQUAL(cache.size(), 0)
+END_SECTION
+
+START_SECTION(Size getCapacity() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getHits() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getMisses() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+  SummedSpectrumCache cache;
+  cache.getSpectrum(SummedSpectrumCache::Key(nullptr, 1, 1, -1, -1, "simple", 0.0), make_spectrum(101.0));
+  TEST_EQUAL(cache.size(), 1)
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
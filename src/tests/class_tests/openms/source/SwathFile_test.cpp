@@ -43,6 +43,12 @@
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 #include <OpenMS/METADATA/Precursor.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QDir>
+
+#include <fstream>
+#include <iterator>
 
 
 using namespace OpenMS;
@@ -173,6 +179,83 @@ START_SECTION([EXTRA]std::vector< OpenSwath::SwathMap > loadMzML(String file, St
 }
 END_SECTION
 
+START_SECTION([EXTRA]std::vector< OpenSwath::SwathMap > loadMzML(String file, String tmp, boost::shared_ptr<ExperimentalSettings>& exp_meta, String readoptions="cachePersistent") )
+{
+  Size nr_swathes = 2;
+
+  // everything is written into a directory of its own, so that all files can be removed afterwards
+  String test_dir = File::getTempDirectory() + "/" + File::getUniqueName() + "/";
+  String cache_dir = test_dir + "cache/";
+  TEST_EQUAL(QDir().mkpath(cache_dir.toQString()), true)
+  TEST_EQUAL(QDir().mkpath((test_dir + "a").toQString()), true)
+  TEST_EQUAL(QDir().mkpath((test_dir + "b").toQString()), true)
+  String source_file = test_dir + "a/run.mzML";
+  storeSwathFile(source_file, nr_swathes);
+
+  QDir cache(cache_dir.toQString());
+  auto listCache = [&cache]() { return String(cache.entryList(QDir::Files, QDir::Name).join(";")); };
+  auto readManifest = [&cache, &cache_dir]()
+  {
+    QStringList manifests = cache.entryList(QStringList() << "*.swathcache", QDir::Files, QDir::Name);
+    if (manifests.size() != 1) return String();
+    std::ifstream is((cache_dir + String(manifests[0])).c_str());
+    return String(std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>()));
+  };
+  auto loadAndCheck = [&](const String& file)
+  {
+    boost::shared_ptr<ExperimentalSettings> meta = boost::shared_ptr<ExperimentalSettings>(new ExperimentalSettings());
+    std::vector< OpenSwath::SwathMap > maps = SwathFile().loadMzML(file, cache_dir, meta, "cachePersistent");
+
+    TEST_EQUAL(maps.size(), nr_swathes+1)
+    TEST_EQUAL(maps[0].ms1, true)
+    TEST_EQUAL(maps[0].sptr->getNrSpectra(), 1)
+    for (Size i = 0; i< nr_swathes; i++)
+    {
+      TEST_EQUAL(maps[i+1].ms1, false)
+      TEST_EQUAL(maps[i+1].sptr->getNrSpectra(), 1)
+      TEST_EQUAL(maps[i+1].sptr->getSpectrumById(0)->getMZArray()->data.size(), 1)
+      TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(0)->getMZArray()->data[0], 101.0+i)
+      TEST_REAL_SIMILAR(maps[i+1].sptr->getSpectrumById(0)->getIntensityArray()->data[0], 201.0+i)
+      TEST_REAL_SIMILAR(maps[i+1].lower, 400+i*25.0)
+      TEST_REAL_SIMILAR(maps[i+1].upper, 425+i*25.0)
+    }
+  };
+
+  // first call builds the cache, second call re-uses it
+  // (a rebuild would write new .cached files under a new unique name and point the manifest to them)
+  loadAndCheck(source_file);
+  String files_after_build = listCache();
+  String manifest_after_build = readManifest();
+  int nr_cache_files = cache.entryList(QDir::Files).size();
+  TEST_EQUAL(manifest_after_build.empty(), false)
+  loadAndCheck(source_file);
+  TEST_EQUAL(listCache(), files_after_build)
+  TEST_EQUAL(readManifest(), manifest_after_build)
+
+  // a stale cache is removed before it is rebuilt, the number of files stays the same
+  {
+    QStringList manifests = cache.entryList(QStringList() << "*.swathcache", QDir::Files);
+    String stale_manifest = manifest_after_build;
+    std::ofstream os((cache_dir + String(manifests[0])).c_str());
+    os << stale_manifest.substitute("OpenSwathPersistentCache\t" + String(SwathFile::PERSISTENT_CACHE_VERSION), "OpenSwathPersistentCache\t0");
+  }
+  loadAndCheck(source_file);
+  TEST_EQUAL(cache.entryList(QDir::Files).size(), nr_cache_files)
+  TEST_NOT_EQUAL(listCache(), files_after_build)
+  TEST_EQUAL(readManifest().hasPrefix("OpenSwathPersistentCache\t" + String(SwathFile::PERSISTENT_CACHE_VERSION)), true)
+
+  // a file with the same name in another directory gets a cache of its own
+  String other_file = test_dir + "b/run.mzML";
+  storeSwathFile(other_file, nr_swathes);
+  loadAndCheck(other_file);
+  TEST_EQUAL(cache.entryList(QStringList() << "*.swathcache", QDir::Files).size(), 2)
+  loadAndCheck(source_file);
+  TEST_EQUAL(cache.entryList(QDir::Files).size(), 2 * nr_cache_files)
+
+  File::removeDirRecursively(test_dir);
+}
+END_SECTION
+
 // medium (2x slower than normal mzML)
 START_SECTION(std::vector< OpenSwath::SwathMap > loadSplit(StringList file_list, String tmp, boost::shared_ptr<ExperimentalSettings>& exp_meta, String readoptions="normal"))
 {
@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumCache.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+///////////////////////////
+
+START_TEST(TheoreticalSpectrumCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+TheoreticalSpectrumCache* ptr = nullptr;
+TheoreticalSpectrumCache* nullPointer = nullptr;
+
+START_SECTION(TheoreticalSpectrumCache(const TheoreticalSpectrumGenerator& generator = TheoreticalSpectrumGenerator(), Size capacity = 10000))
+  ptr = new TheoreticalSpectrumCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getCapacity(), 10000)
+  TEST_EQUAL(ptr->size(), 0)
+END_SECTION
+
+START_SECTION(virtual ~TheoreticalSpectrumCache())
+  delete ptr;
+END_SECTION
+
+AASequence peptide = AASequence::fromString("IFSQVGK");
+AASequence peptide2 = AASequence::fromString("IFSQVGKM(Oxidation)");
+AASequence peptide3 = AASequence::fromString("PEPTIDEK");
+
+TheoreticalSpectrumGenerator tsg;
+Param param = tsg.getParameters();
+param.setValue("add_metainfo", "true");
+tsg.setParameters(param);
+
+START_SECTION(SpectrumPtr getSpectrum(const AASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge = 0))
+  TheoreticalSpectrumCache cache(tsg, 2);
+
+  PeakSpectrum expected;
+  tsg.getSpectrum(expected, peptide, 1, 2);
+
+  TheoreticalSpectrumCache::SpectrumPtr spec = cache.getSpectrum(peptide, 1, 2);
+  TEST_EQUAL(*spec == expected, true)
+  TEST_EQUAL(spec->getStringDataArrays().size(), 1)
+  TEST_EQUAL(cache.getMisses(), 1)
+  TEST_EQUAL(cache.getHits(), 0)
+
+  // same request is answered from the cache
+  TheoreticalSpectrumCache::SpectrumPtr spec2 = cache.getSpectrum(peptide, 1, 2);
+  TEST_EQUAL(spec.get(), spec2.get())
+  TEST_EQUAL(cache.getHits(), 1)
+
+  // different charge range and modified sequence are different entries
+  TheoreticalSpectrumCache::SpectrumPtr spec3 = cache.getSpectrum(peptide, 1, 1);
+  TEST_NOT_EQUAL(spec.get(), spec3.get())
+  TEST_EQUAL(spec3->size() < spec->size(), true)
+  cache.getSpectrum(peptide2, 1, 2);
+  TEST_EQUAL(cache.getMisses(), 3)
+  TEST_EQUAL(cache.size(), 2)
+
+  // (peptide, 1, 2) was least recently used and has been evicted, the returned pointer stays valid
+  cache.getSpectrum(peptide, 1, 2);
+  TEST_EQUAL(cache.getMisses(), 4)
+  TEST_EQUAL(*spec == expected, true)
+
+  // empty peptide gives empty spectrum
+  TEST_EQUAL(cache.getSpectrum(AASequence(), 1, 2)->size(), 0)
+END_SECTION
+
+START_SECTION(void setGenerator(const TheoreticalSpectrumGenerator& generator))
+  TheoreticalSpectrumCache cache(tsg);
+  cache.getSpectrum(peptide, 1, 1);
+  TEST_EQUAL(cache.size(), 1)
+
+  // m/z-only generation
+  TheoreticalSpectrumGenerator tsg_mz;
+  Param p = tsg_mz.getParameters();
+  p.setValue("add_metainfo", "false");
+  tsg_mz.setParameters(p);
+  cache.setGenerator(tsg_mz);
+  TEST_EQUAL(cache.size(), 0)
+  TEST_EQUAL(cache.getSpectrum(peptide, 1, 1)->getStringDataArrays().empty(), true)
+END_SECTION
+
+START_SECTION(TheoreticalSpectrumGenerator getGenerator() const)
+  TheoreticalSpectrumCache cache(tsg);
+  TEST_EQUAL(cache.getGenerator().getParameters(), tsg.getParameters())
+END_SECTION
+
+START_SECTION(void setCapacity(Size capacity))
+  TheoreticalSpectrumCache cache(tsg, 3);
+  cache.getSpectrum(peptide, 1, 1);
+  cache.getSpectrum(peptide2, 1, 1);
+  cache.getSpectrum(peptide3, 1, 1);
+  TEST_EQUAL(cache.size(), 3)
+  cache.setCapacity(1);
+  TEST_EQUAL(cache.size(), 1)
+  // most recently used entry is kept
+  cache.getSpectrum(peptide3, 1, 1);
+  TEST_EQUAL(cache.getHits(), 1)
+
+  // capacity 0 disables caching
+  cache.setCapacity(0);
+  TEST_EQUAL(cache.getSpectrum(peptide, 1, 1)->empty(), false)
+  TEST_EQUAL(cache.size(), 0)
+END_SECTION
+
+START_SECTION(Size getCapacity() const)
+  TheoreticalSpectrumCache cache(tsg, 5);
+  TEST_EQUAL(cache.getCapacity(), 5)
+END_SECTION
+
+START_SECTION(Size size() const)
+  TheoreticalSpectrumCache cache(tsg);
+  TEST_EQUAL(cache.size(), 0)
+  cache.getSpectrum(peptide, 1, 1);
+  TEST_EQUAL(cache.size(), 1)
+END_SECTION
+
+START_SECTION(void clear())
+  TheoreticalSpectrumCache cache(tsg);
+  cache.getSpectrum(peptide, 1, 1);
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+END_SECTION
+
+START_SECTION(Size getHits() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getMisses() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -80,6 +80,42 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenSwath::LightTargetedExperiment & targeted_exp, bool legacy_traml_id))
+{
+  TransitionPQPFile pqp_reader;
+  OpenSwath::LightTargetedExperiment targeted_exp;
+  pqp_reader.convertPQPToTargetedExperiment(OPENMS_GET_TEST_DATA_PATH("../../../topp/TargetedFileConverter_10_input.pqp"), targeted_exp);
+  TEST_EQUAL(targeted_exp.getTransitions().size(), 44)
+  TEST_EQUAL(targeted_exp.getCompounds().size(), 8)
+}
+END_SECTION
+
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenSwath::LightTargetedExperiment & targeted_exp, double precursor_mz_lower, double precursor_mz_upper, bool legacy_traml_id))
+{
+  TransitionPQPFile pqp_reader;
+  OpenSwath::LightTargetedExperiment targeted_exp;
+  pqp_reader.convertPQPToTargetedExperiment(OPENMS_GET_TEST_DATA_PATH("../../../topp/TargetedFileConverter_10_input.pqp"), targeted_exp, 280.0, 300.0);
+  TEST_EQUAL(targeted_exp.getTransitions().size(), 8)
+  TEST_EQUAL(targeted_exp.getCompounds().size(), 3)
+  for (const auto& tr : targeted_exp.getTransitions())
+  {
+    TEST_EQUAL(tr.precursor_mz >= 280.0 && tr.precursor_mz < 300.0, true)
+  }
+
+  // the full range gives the same result as the unrestricted overload
+  OpenSwath::LightTargetedExperiment targeted_exp_all;
+  pqp_reader.convertPQPToTargetedExperiment(OPENMS_GET_TEST_DATA_PATH("../../../topp/TargetedFileConverter_10_input.pqp"), targeted_exp_all, 0.0, 1e6);
+  TEST_EQUAL(targeted_exp_all.getTransitions().size(), 44)
+  TEST_EQUAL(targeted_exp_all.getCompounds().size(), 8)
+
+  // empty range
+  OpenSwath::LightTargetedExperiment targeted_exp_none;
+  pqp_reader.convertPQPToTargetedExperiment(OPENMS_GET_TEST_DATA_PATH("../../../topp/TargetedFileConverter_10_input.pqp"), targeted_exp_none, 500.0, 600.0);
+  TEST_EQUAL(targeted_exp_none.getTransitions().size(), 0)
+  TEST_EQUAL(targeted_exp_none.getCompounds().size(), 0)
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
@@ -263,12 +263,13 @@ protected:
       // run feature detection
       //-------------------------------------------------------------
 
-      ffid_algo.run(peptides, proteins, peptides_ext, proteins_ext, features);
-
       // write auxiliary output:
       bool keep_chromatograms = !chrom_out.empty();
       bool keep_library = !lib_out.empty();
 
+      ffid_algo.setKeepChromatograms(keep_chromatograms);
+      ffid_algo.run(peptides, proteins, peptides_ext, proteins_ext, features);
+
       // keep assay data for output?
       if (keep_library)
       {
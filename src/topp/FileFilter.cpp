@@ -53,6 +53,7 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <exception>
 #include <memory>
 
 using namespace OpenMS;
@@ -851,15 +852,33 @@ protected:
         SignalToNoiseEstimatorMedian<MapType::SpectrumType> snm;
         Param const& dc_param = getParam_().copy("algorithm:SignalToNoise:", true);
         snm.setParameters(dc_param);
-        for (auto& spec : exp)
+        // spectra are independent, each thread uses its own copy of the estimator
+        std::exception_ptr sn_error;
+#ifdef _OPENMP
+#pragma omp parallel for firstprivate(snm) schedule(dynamic, 16)
+#endif
+        for (SignedSize s = 0; s < (SignedSize)exp.size(); ++s)
         {
-          snm.init(spec);
-          for (Size i = 0; i != spec.size(); ++i)
+          MapType::SpectrumType& spec = exp[s];
+          try
           {
-            if (snm.getSignalToNoise(i) < sn) spec[i].setIntensity(0);
+            snm.init(spec);
+            for (Size i = 0; i != spec.size(); ++i)
+            {
+              if (snm.getSignalToNoise(i) < sn) spec[i].setIntensity(0);
+            }
+            spec.erase(remove_if(spec.begin(), spec.end(), InIntensityRange<MapType::PeakType>(1, numeric_limits<MapType::PeakType::IntensityType>::max(), true)), spec.end());
+          }
+          catch (...)
+          {
+            // cannot throw inside the parallel region, rethrow after the loop
+#ifdef _OPENMP
+#pragma omp critical (FileFilter_sn_error)
+#endif
+            if (!sn_error) sn_error = std::current_exception();
           }
-          spec.erase(remove_if(spec.begin(), spec.end(), InIntensityRange<MapType::PeakType>(1, numeric_limits<MapType::PeakType::IntensityType>::max(), true)), spec.end());
         }
+        if (sn_error) std::rethrow_exception(sn_error);
       }
 
       //
@@ -40,6 +40,7 @@
 #include <OpenMS/DATASTRUCTURES/StringListUtils.h>
 
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -98,35 +99,6 @@ public:
   {
   }
 
-  /**
-    @brief Helper class for the Low Memory Noise filtering
-  */
-  class NFGaussMzMLConsumer :
-    public MSDataWritingConsumer 
-  {
-
-  public:
-
-    NFGaussMzMLConsumer(const String& filename, const GaussFilter& gf) :
-      MSDataWritingConsumer(filename) 
-    {
-      gf_ = gf;
-    }
-
-    void processSpectrum_(MapType::SpectrumType& s) override
-    {
-      gf_.filter(s);
-    }
-
-    void processChromatogram_(MapType::ChromatogramType& c) override 
-    {
-      gf_.filter(c);
-    }
-
-  private:
-    GaussFilter gf_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input raw data file ");
@@ -148,10 +120,16 @@ public:
   ExitCodes doLowMemAlgorithm(const GaussFilter& gauss)
   {
     ///////////////////////////////////
-    // Create the consumer object, add data processing
+    // Create the consumer objects, add data processing
     ///////////////////////////////////
-    NFGaussMzMLConsumer gaussConsumer(out, gauss);
-    gaussConsumer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+    PlainMSDataWritingConsumer writer(out);
+    writer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+
+    // spectra are smoothed in parallel, the filter does not change its state while filtering
+    GaussFilter gf = gauss;
+    MSDataParallelTransformingConsumer gaussConsumer(&writer);
+    gaussConsumer.setSpectraProcessingFunc([&gf](MSSpectrum& s) { gf.filter(s); });
+    gaussConsumer.setChromatogramProcessingFunc([&gf](MSChromatogram& c) { gf.filter(c); });
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
@@ -159,6 +137,7 @@ public:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &gaussConsumer);
+    gaussConsumer.flush();
 
     return EXECUTION_OK;
   }
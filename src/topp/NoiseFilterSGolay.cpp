@@ -39,6 +39,7 @@
 #include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
 using namespace OpenMS;
@@ -101,35 +102,6 @@ public:
   {
   }
 
-  /**
-    @brief Helper class for the Low Memory Noise filtering
-  */
-  class NFSGolayMzMLConsumer :
-    public MSDataWritingConsumer 
-  {
-
-  public:
-
-    NFSGolayMzMLConsumer(const String& filename, const SavitzkyGolayFilter& sgf) :
-      MSDataWritingConsumer(filename) 
-    {
-      sgf_ = sgf;
-    }
-
-    void processSpectrum_(MapType::SpectrumType& s) override
-    {
-      sgf_.filter(s);
-    }
-
-    void processChromatogram_(MapType::ChromatogramType& c) override 
-    {
-      sgf_.filter(c);
-    }
-
-  private:
-    SavitzkyGolayFilter sgf_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input raw data file ");
@@ -151,10 +123,17 @@ public:
   ExitCodes doLowMemAlgorithm(const SavitzkyGolayFilter& sgolay)
   {
     ///////////////////////////////////
-    // Create the consumer object, add data processing
+    // Create the consumer objects, add data processing
     ///////////////////////////////////
-    NFSGolayMzMLConsumer sgolayConsumer(out, sgolay);
-    sgolayConsumer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+    PlainMSDataWritingConsumer writer(out);
+    writer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+
+    // spectra are smoothed in parallel, all threads share the filter since
+    // filtering only reads its coefficients
+    SavitzkyGolayFilter sgf = sgolay;
+    MSDataParallelTransformingConsumer sgolayConsumer(&writer);
+    sgolayConsumer.setSpectraProcessingFunc([&sgf](MSSpectrum& s) { sgf.filter(s); });
+    sgolayConsumer.setChromatogramProcessingFunc([&sgf](MSChromatogram& c) { sgf.filter(c); });
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
@@ -162,6 +141,7 @@ public:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &sgolayConsumer);
+    sgolayConsumer.flush();
 
     return EXECUTION_OK;
   }
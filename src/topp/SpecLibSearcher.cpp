@@ -163,15 +163,41 @@ protected:
     addEmptyLine_();
   }
 
-  using MapLibraryPrecursorToLibrarySpectrum = multimap<double, PeakSpectrum>;
-    
-  MapLibraryPrecursorToLibrarySpectrum annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
+  /// A preprocessed library spectrum. The binned spectrum is only filled if the scoring function works on binned spectra.
+  struct LibraryEntry
+  {
+    double precursor_mz;
+    PeakSpectrum spectrum;
+    BinnedSpectrum binned_spectrum;
+  };
+
+  /// Library entries sorted by precursor m/z (stable, i.e. entries with equal m/z keep their order in the library file)
+  using LibraryIndex = vector<LibraryEntry>;
+
+  struct LibraryEntryPrecursorLess
+  {
+    bool operator()(const LibraryEntry& a, const LibraryEntry& b) const
+    {
+      return a.precursor_mz < b.precursor_mz;
+    }
+    bool operator()(const LibraryEntry& a, double b) const
+    {
+      return a.precursor_mz < b;
+    }
+    bool operator()(double a, const LibraryEntry& b) const
+    {
+      return a < b.precursor_mz;
+    }
+  };
+
+  LibraryIndex annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
     const PeakMap& library, 
     StringList variable_modifications, 
     StringList fixed_modifications,
     double remove_peaks_below_threshold)
   {
-    MapLibraryPrecursorToLibrarySpectrum annotated_lib;
+    LibraryIndex annotated_lib;
+    annotated_lib.reserve(library.size());
 
     ModificationsDB* mdb = ModificationsDB::getInstance();
 
@@ -263,8 +289,9 @@ protected:
            lib_entry.push_back(peak);
          }
        }
-       annotated_lib.insert(make_pair(precursor_MZ, lib_entry));
+       annotated_lib.push_back(LibraryEntry{precursor_MZ, std::move(lib_entry), BinnedSpectrum()});
      }
+    std::stable_sort(annotated_lib.begin(), annotated_lib.end(), LibraryEntryPrecursorLess());
     return annotated_lib;
   }
 
@@ -352,18 +379,26 @@ protected:
     cout << endl;
     */
 
-    MapLibraryPrecursorToLibrarySpectrum mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+    LibraryIndex mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+
+    // the SpectraST score compares normalized binned spectra: bin the library once instead of once per query and candidate
+    const bool spectrast_score = (compare_function == "SpectraSTSimilarityScore");
+    if (spectrast_score)
+    {
+      SpectraSTSimilarityScore sp;
+#pragma omp parallel for firstprivate(sp)
+      for (SignedSize i = 0; i < static_cast<SignedSize>(mslib.size()); ++i)
+      {
+        mslib[i].binned_spectrum = sp.transform(mslib[i].spectrum);
+      }
+    }
 
     time_t end_build_time = time(nullptr);
     OPENMS_LOG_INFO << "Time needed for preprocessing data: " << (end_build_time - start_build_time) << "\n";
 
-    //compare function
-    PeakSpectrumCompareFunctor* comparor = Factory<PeakSpectrumCompareFunctor>::create(compare_function);
- 
    //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    double score;
     StringList::iterator in, out_file;
     for (in  = in_spec.begin(), out_file  = out.begin(); in < in_spec.end(); ++in, ++out_file)
     {
@@ -403,179 +438,223 @@ protected:
       /***********SEARCH**********/
       for (UInt j = 0; j < query.size(); ++j)
       {
-        //Set identifier for each identifications
-        PeptideIdentification pid;
-        pid.setIdentifier("test");
-        pid.setScoreType(compare_function);
         ProteinHit pr_hit;
         pr_hit.setAccession(j);
         prot_id.insertHit(pr_hit);
+      }
 
-        // proper MS2?
-        if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
-
-        if (query[j].getPrecursors().empty())
-        {
-          writeLog_("Warning MS2 spectrum without precursor information");
-          continue;
-        }
-
-        // filter query spectrum
-        double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
-                                [](const Peak1D& l, const Peak1D& r) 
-                                { 
-                                  return (l.getIntensity() < r.getIntensity()); 
-                                })->getIntensity();
-
-        double min_high_intensity = max_intensity / cut_peaks_below;
+      // query spectra are independent: search them in parallel and collect the results in query order
+      vector<PeptideIdentification> query_ids(query.size());
+      vector<char> query_identified(query.size(), false);
+      vector<std::exception_ptr> errors(query.size());
+      std::exception_ptr factory_error;
 
-        PeakSpectrum filtered_query;
-        for (UInt k = 0; k < query[j].size(); ++k)
+#pragma omp parallel
+      {
+        // compare functors may keep internal state, so every thread uses its own instance
+        // (the Factory singleton is not thread-safe, hence the instances are created one at a time)
+        PeakSpectrumCompareFunctor* comparor = nullptr;
+#pragma omp critical (SpecLibSearcher_factory)
         {
-          if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
-           && query[j][k].getIntensity() >= min_high_intensity)
+          try
+          {
+            comparor = Factory<PeakSpectrumCompareFunctor>::create(compare_function);
+          }
+          catch (...)
           {
-            Peak1D peak;
-            peak.setIntensity(sqrt(query[j][k].getIntensity()));
-            peak.setMZ(query[j][k].getMZ());
-            filtered_query.push_back(peak);
+            factory_error = std::current_exception();
           }
         }
 
-        // retain only top N peaks
-        if (filtered_query.size() > max_peaks)
+#pragma omp for schedule(dynamic)
+        for (SignedSize j = 0; j < static_cast<SignedSize>(query.size()); ++j)
         {
-          filtered_query.sortByIntensity(true);
-          filtered_query.resize(max_peaks);
-          filtered_query.sortByPosition();
-        }
+          if (comparor == nullptr) { continue; } // creation failed, reported after the parallel region
 
-        if (filtered_query.size() < min_peaks) { continue; }
+          try
+          {
+            //Set identifier for each identifications
+            PeptideIdentification pid;
+            pid.setIdentifier("test");
+            pid.setScoreType(compare_function);
+            const String pr_accession(j);
 
-        const double& query_rt = query[j].getRT();
-        const int& query_charge = query[j].getPrecursors()[0].getCharge();
-        const double query_mz = query[j].getPrecursors()[0].getMZ();
-        
-        if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
+            // proper MS2?
+            if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
 
-        for (auto const & iso : isotopes)
-        {
-          // isotopic misassignment corrected query
-          const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
+            if (query[j].getPrecursors().empty())
+            {
+#pragma omp critical (SpecLibSearcher_log)
+              writeLog_("Warning MS2 spectrum without precursor information");
+              continue;
+            }
 
-          // if tolerance unit is ppm convert to m/z
-          const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
+            // filter query spectrum
+            double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
+                                    [](const Peak1D& l, const Peak1D& r) 
+                                    { 
+                                      return (l.getIntensity() < r.getIntensity()); 
+                                    })->getIntensity();
 
-          // skip matching of isotopic misassignments if charge not annotated
-          if (iso != 0 && query_charge == 0) { continue; }
+            double min_high_intensity = max_intensity / cut_peaks_below;
 
-          // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
-          const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
-          if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+            PeakSpectrum filtered_query;
+            for (UInt k = 0; k < query[j].size(); ++k)
+            {
+              if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
+               && query[j][k].getIntensity() >= min_high_intensity)
+              {
+                Peak1D peak;
+                peak.setIntensity(sqrt(query[j][k].getIntensity()));
+                peak.setMZ(query[j][k].getMZ());
+                filtered_query.push_back(peak);
+              }
+            }
 
-          /* TODO: remove old code for charge estimation?
-          bool charge_one = false;
-          Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
-          Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
-          for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
-          {
-            if (peak->getMZ() < query_MZ)
+            // retain only top N peaks
+            if (filtered_query.size() > max_peaks)
             {
-              break;
+              filtered_query.sortByIntensity(true);
+              filtered_query.resize(max_peaks);
+              filtered_query.sortByPosition();
             }
-          }
-          if (percent > margin)
-          {
-            charge_one = true;
-          }
-          */
 
+            if (filtered_query.size() < min_peaks) { continue; }
 
-          // determine MS2 precursors that match to the current peptide mass
-          MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
-        
-          low_it = mslib.lower_bound(ic_query_mz - 0.5 * precursor_mass_tolerance_mz);
-          up_it = mslib.upper_bound(ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
+            const double& query_rt = query[j].getRT();
+            const int& query_charge = query[j].getPrecursors()[0].getCharge();
+            const double query_mz = query[j].getPrecursors()[0].getMZ();
         
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
-       
-          for (; low_it != up_it; ++low_it)
-          {
-            const PeakSpectrum& lib_spec = low_it->second;;
-            PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
-            const int& lib_charge = hit.getCharge();  
-
-            // check if charge state between library and experimental spectrum match
-            if (query_charge > 0 && lib_charge != query_charge) { continue; }
+            if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
 
-            // Special treatment for SpectraST score as it computes a score based on the whole library
-            if (compare_function == "SpectraSTSimilarityScore")
+            // the query is binned only once and compared against the pre-binned library spectra
+            BinnedSpectrum quer_bin_spec;
+            if (spectrast_score)
             {
-              SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-              BinnedSpectrum quer_bin_spec = sp->transform(filtered_query);
-              BinnedSpectrum lib_bin_spec = sp->transform(lib_spec);
-              score = (*sp)(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
-              double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
-              hit.setMetaValue("DOTBIAS", dot_bias);
+              quer_bin_spec = static_cast<SpectraSTSimilarityScore*>(comparor)->transform(filtered_query);
             }
-            else
+
+            for (auto const & iso : isotopes)
             {
-              score = (*comparor)(filtered_query, lib_spec);
-            }
+              // isotopic misassignment corrected query
+              const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
 
-            DataValue RT(lib_spec.getRT());
-            DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
-            hit.setMetaValue("lib:RT", RT);
-            hit.setMetaValue("lib:MZ", MZ);
-            hit.setMetaValue(Constants::UserParam::ISOTOPE_ERROR, iso);
-            hit.setScore(score);
-            PeptideEvidence pe;
-            pe.setProteinAccession(pr_hit.getAccession());
-            hit.addPeptideEvidence(pe);
-            pid.insertHit(hit);
-          }
-        }
+              // if tolerance unit is ppm convert to m/z
+              const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
 
-        pid.setHigherScoreBetter(true);
-        pid.sort();
+              // skip matching of isotopic misassignments if charge not annotated
+              if (iso != 0 && query_charge == 0) { continue; }
 
-        if (compare_function == "SpectraSTSimilarityScore")
-        {
-          if (!pid.empty() && !pid.getHits().empty())
-          {
-            vector<PeptideHit> final_hits;
-            final_hits.resize(pid.getHits().size());
-            SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-            Size runner_up = 1;
-            for (; runner_up < pid.getHits().size(); ++runner_up)
+              // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
+              const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
+              if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+
+              // determine MS2 precursors that match to the current peptide mass
+              LibraryIndex::const_iterator low_it = std::lower_bound(mslib.cbegin(), mslib.cend(), ic_query_mz - 0.5 * precursor_mass_tolerance_mz, LibraryEntryPrecursorLess());
+              LibraryIndex::const_iterator up_it = std::upper_bound(low_it, mslib.cend(), ic_query_mz + 0.5 * precursor_mass_tolerance_mz, LibraryEntryPrecursorLess());
+        
+              for (; low_it != up_it; ++low_it)
+              {
+                const PeakSpectrum& lib_spec = low_it->spectrum;
+                PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
+                const int& lib_charge = hit.getCharge();  
+
+                // check if charge state between library and experimental spectrum match
+                if (query_charge > 0 && lib_charge != query_charge) { continue; }
+
+                double score;
+                // Special treatment for SpectraST score as it computes a score based on the whole library
+                if (spectrast_score)
+                {
+                  SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
+                  const BinnedSpectrum& lib_bin_spec = low_it->binned_spectrum;
+                  score = (*sp)(quer_bin_spec, lib_bin_spec);
+                  double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
+                  hit.setMetaValue("DOTBIAS", dot_bias);
+                }
+                else
+                {
+                  score = (*comparor)(filtered_query, lib_spec);
+                }
+
+                DataValue RT(lib_spec.getRT());
+                DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
+                hit.setMetaValue("lib:RT", RT);
+                hit.setMetaValue("lib:MZ", MZ);
+                hit.setMetaValue(Constants::UserParam::ISOTOPE_ERROR, iso);
+                hit.setScore(score);
+                PeptideEvidence pe;
+                pe.setProteinAccession(pr_accession);
+                hit.addPeptideEvidence(pe);
+                pid.insertHit(hit);
+              }
+            }
+
+            pid.setHigherScoreBetter(true);
+            pid.sort();
+
+            if (spectrast_score)
             {
-              if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
-               || runner_up > 5)
+              if (!pid.empty() && !pid.getHits().empty())
               {
-                break;
+                vector<PeptideHit> final_hits;
+                final_hits.resize(pid.getHits().size());
+                SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
+                Size runner_up = 1;
+                for (; runner_up < pid.getHits().size(); ++runner_up)
+                {
+                  if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
+                   || runner_up > 5)
+                  {
+                    break;
+                  }
+                }
+                double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
+                for (Size s = 0; s < pid.getHits().size(); ++s)
+                {
+                  final_hits[s] = pid.getHits()[s];
+                  final_hits[s].setMetaValue("delta D", delta_D);
+                  final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
+                  final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+                }
+                pid.setHits(final_hits);
+                pid.sort();
+                pid.setMZ(query[j].getPrecursors()[0].getMZ());
+                pid.setRT(query_rt);
               }
             }
-            double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
-            for (Size s = 0; s < pid.getHits().size(); ++s)
+
+            if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
             {
-              final_hits[s] = pid.getHits()[s];
-              final_hits[s].setMetaValue("delta D", delta_D);
-              final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
-              final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+              pid.getHits().resize(top_hits);
             }
-            pid.setHits(final_hits);
-            pid.sort();
-            pid.setMZ(query[j].getPrecursors()[0].getMZ());
-            pid.setRT(query_rt);
+            query_ids[j] = std::move(pid);
+            query_identified[j] = true;
+          }
+          catch (...)
+          {
+            // cannot throw inside the parallel region (e.g. division by zero in SpectraST's delta D)
+            errors[j] = std::current_exception();
           }
         }
 
-        if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
+        delete comparor;
+      }
+
+      if (factory_error)
+      {
+        std::rethrow_exception(factory_error);
+      }
+      for (Size j = 0; j < query.size(); ++j)
+      {
+        if (errors[j])
+        {
+          std::rethrow_exception(errors[j]);
+        }
+        if (query_identified[j])
         {
-          pid.getHits().resize(top_hits);
+          peptide_ids.push_back(std::move(query_ids[j]));
         }
-        peptide_ids.push_back(pid);
       }
       protein_ids.push_back(prot_id);
 
@@ -45,6 +45,7 @@
 #include <OpenMS/FORMAT/TransformationXMLFile.h>
 #include <OpenMS/FORMAT/SwathFile.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChainingConsumer.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SwathWindowLoader.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SwathQC.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVFile.h>
@@ -138,7 +139,10 @@ using namespace OpenMS;
   Since the file size can become rather large, it is recommended to not load the
   whole file into memory but rather cache it somewhere on the disk using a
   fast-access data format. This can be specified using the -readOptions cache
-  parameter (this is recommended!).
+  parameter (this is recommended!). When the same file is analyzed repeatedly
+  (e.g. with different assay libraries or parameters), use -readOptions
+  cachePersistent together with a fixed -tempDirectory: the cache is built by
+  the first run and opened read-only by all subsequent (also concurrent) runs.
 
   The assay library (transition list) is provided through the @p -tr parameter and can be in one of the following formats:
   
@@ -509,6 +513,8 @@ protected:
     registerStringOption_("irt_mz_extraction_window_unit", "<name>", "ppm", "Unit for mz extraction", false, true);
     setValidStrings_("irt_mz_extraction_window_unit", ListUtils::create<String>("Th,ppm"));
     registerDoubleOption_("irt_im_extraction_window", "<double>", -1, "Ion mobility extraction window used for iRT (in 1/K0 or milliseconds)", false, true);
+    registerStringOption_("irt_streaming_extraction", "<name>", "true", "Extract the iRT chromatograms while the input data is loaded instead of in a second pass through the data. Only used for single mzML input files with readOptions normal or cache, and not for SONAR, PRM, ion mobility extraction or a swath_windows_file.", false, true);
+    setValidStrings_("irt_streaming_extraction", ListUtils::create<String>("true,false"));
 
     registerDoubleOption_("min_rsq", "<double>", 0.95, "Minimum r-squared of RT peptides regression", false, true);
     registerDoubleOption_("min_coverage", "<double>", 0.6, "Minimum relative amount of RT peptides to keep", false, true);
@@ -516,8 +522,8 @@ protected:
     registerFlag_("split_file_input", "The input files each contain one single SWATH (alternatively: all SWATH are in separate files)", true);
     registerFlag_("use_elution_model_score", "Turn on elution model score (EMG fit to peak)", true);
 
-    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory", false, true);
-    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory"));
+    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory. cachePersistent keeps the cache in tempDirectory and re-uses it in later runs on the same (unchanged) mzML file", false, true);
+    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,cachePersistent,workingInMemory"));
 
     registerStringOption_("mz_correction_function", "<name>", "none", "Use the retention time normalization peptide MS2 masses to perform a mass correction (linear, weighted by intensity linear or quadratic) of all spectra.", false, true);
     setValidStrings_("mz_correction_function", ListUtils::create<String>("none,regression_delta_ppm,unweighted_regression,weighted_regression,quadratic_regression,weighted_quadratic_regression,weighted_quadratic_regression_delta_ppm,quadratic_regression_delta_ppm"));
@@ -529,7 +535,7 @@ protected:
 
     registerIntOption_("batchSize", "<number>", 1000, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 250-1000)", false, true);
     setMinInt_("batchSize", 0);
-    registerIntOption_("outer_loop_threads", "<number>", -1, "How many threads should be used for the outer loop (-1 use all threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
+    registerIntOption_("outer_loop_threads", "<number>", -1, "How many SWATH windows should be analyzed (and held in memory) at once; all threads share the work on these windows (-1 use as many windows as threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
 
     registerIntOption_("ms1_isotopes", "<number>", 3, "The number of MS1 isotopes used for extraction", false, true);
     setMinInt_("ms1_isotopes", 0);
@@ -802,54 +808,100 @@ protected:
       feature_finder_param.setValue("Scores:use_uis_scores", "true");
     }
 
-    ///////////////////////////////////
-    // Load the transitions
-    ///////////////////////////////////
-    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
-    OPENMS_LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
-      transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
-
-    if (tr_type == FileTypes::PQP)
-    {
-      if (!out_osw.empty())
-      { // copy the PQP file and name it OSW file
-        std::ifstream  src(tr_file.c_str(), std::ios::binary);
-        std::ofstream  dst(out_osw.c_str(), std::ios::binary | std::ios::trunc);
-        dst << src.rdbuf();
-      }
-    }
-
     ///////////////////////////////////
     // Load the SWATH files
     ///////////////////////////////////
     boost::shared_ptr<ExperimentalSettings> exp_meta(new ExperimentalSettings);
     std::vector< OpenSwath::SwathMap > swath_maps;
 
+    // The iRT chromatograms can be extracted from the spectra as they are
+    // read, if the spectra seen by the plugin map 1:1 onto the final SWATH maps
+    bool stream_irt = trafo_in.empty() && !irt_tr_file.empty() &&
+                      getStringOption_("irt_streaming_extraction") == "true" &&
+                      file_list.size() == 1 && !split_file &&
+                      FileHandler::getTypeByFileName(file_list[0]) == FileTypes::MZML &&
+                      (readoptions == "normal" || readoptions == "cache") &&
+                      swath_windows_file.empty() && !sonar && !prm &&
+                      cp_irt.im_extraction_window <= 0.0 && cp_irt.extraction_function == "tophat";
+
+    std::vector< OpenMS::MSChromatogram > streamed_irt_chromatograms;
+    OpenSwath::LightTargetedExperiment irt_transitions; // loaded once, re-used for the calibration
+    OpenSwathCalibrationWorkflow irt_wf;
+    MSDataTransformingConsumer irt_consumer;
+    MSDataChainingConsumer plugin_consumer;
+    if (stream_irt)
+    {
+      std::cout << "Will load iRT transitions and try to find iRT peptides" << std::endl;
+      irt_transitions = loadTransitionList(FileHandler::getType(irt_tr_file),
+          irt_tr_file, TransitionTSVFile().getDefaults());
+      irt_consumer.setSpectraProcessingFunc(irt_wf.getStreamingExtractionFunc(irt_transitions, cp_irt));
+      plugin_consumer.appendConsumer(&irt_consumer);
+    }
+
     // collect some QC data
+    OpenSwath::SwathQC qc(30, 0.04);
+    MSDataTransformingConsumer qc_consumer; // apply some transformation
     if (!out_qc.empty())
     {
-      OpenSwath::SwathQC qc(30, 0.04);
-      MSDataTransformingConsumer qc_consumer; // apply some transformation
       qc_consumer.setSpectraProcessingFunc(qc.getSpectraProcessingFunc());
       qc_consumer.setExperimentalSettingsFunc(qc.getExpSettingsFunc());
-      if (!loadSwathFiles(file_list, exp_meta, swath_maps, split_file, tmp_dir, readoptions, 
-                          swath_windows_file, min_upper_edge_dist, force,
-                          sort_swath_maps, sonar, prm, &qc_consumer))
-      {
-        return PARSE_ERROR;
-      }
+      plugin_consumer.appendConsumer(&qc_consumer);
+    }
+
+    if (!loadSwathFiles(file_list, exp_meta, swath_maps, split_file, tmp_dir, readoptions, 
+                        swath_windows_file, min_upper_edge_dist, force,
+                        sort_swath_maps, sonar, prm,
+                        (stream_irt || !out_qc.empty()) ? &plugin_consumer : nullptr))
+    {
+      return PARSE_ERROR;
+    }
+    if (!out_qc.empty())
+    {
       qc.storeJSON(out_qc);
     }
-    else
+    if (stream_irt)
+    {
+      irt_wf.retrieveStreamingChromatograms(streamed_irt_chromatograms);
+    }
+
+
+    ///////////////////////////////////
+    // Load the transitions
+    ///////////////////////////////////
+    // Precursors outside of all SWATH windows are never extracted, so a PQP
+    // library only needs to be read for the m/z range covered by the windows
+    double precursor_mz_lower = -std::numeric_limits<double>::max();
+    double precursor_mz_upper = std::numeric_limits<double>::max();
+    if (!sonar && !prm)
     {
-      if (!loadSwathFiles(file_list, exp_meta, swath_maps, split_file, tmp_dir, readoptions, 
-                          swath_windows_file, min_upper_edge_dist, force,
-                          sort_swath_maps, sonar, prm))
+      double window_lower = std::numeric_limits<double>::max();
+      double window_upper = -std::numeric_limits<double>::max();
+      for (const auto& m : swath_maps)
+      {
+        if (m.ms1) continue;
+        window_lower = std::min(window_lower, m.lower);
+        window_upper = std::max(window_upper, m.upper);
+      }
+      if (window_lower <= window_upper)
       {
-        return PARSE_ERROR;
+        precursor_mz_lower = window_lower;
+        precursor_mz_upper = window_upper;
       }
     }
+    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param,
+                                                                           precursor_mz_lower, precursor_mz_upper);
+    OPENMS_LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
+      transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
 
+    if (tr_type == FileTypes::PQP)
+    {
+      if (!out_osw.empty())
+      { // copy the PQP file and name it OSW file
+        std::ifstream  src(tr_file.c_str(), std::ios::binary);
+        std::ofstream  dst(out_osw.c_str(), std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf();
+      }
+    }
 
     ///////////////////////////////////
     // Get the transformation information (using iRT peptides)
@@ -869,7 +921,9 @@ protected:
                                         min_rsq, min_coverage, feature_finder_param,
                                         cp_irt, irt_detection_param, calibration_param,
                                         debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
+                                        irt_trafo_out, irt_mzml_out,
+                                        stream_irt ? &irt_transitions : nullptr,
+                                        stream_irt ? &streamed_irt_chromatograms : nullptr);
     }
     else
     {
@@ -885,7 +939,9 @@ protected:
                                         min_rsq, min_coverage, feature_finder_param,
                                         cp_irt, linear_irt, no_calibration,
                                         debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
+                                        irt_trafo_out, irt_mzml_out,
+                                        stream_irt ? &irt_transitions : nullptr,
+                                        stream_irt ? &streamed_irt_chromatograms : nullptr);
 
       cp_irt.rt_extraction_window = 900; // extract some substantial part of the RT range (should be covered by linear correction)
       cp_irt.rt_extraction_window = 600; // extract some substantial part of the RT range (should be covered by linear correction)